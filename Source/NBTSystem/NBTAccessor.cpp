@@ -8,18 +8,16 @@ FNBTDataAccessor FNBTDataAccessor::MakeAccessFromFName(FName Key) const {
     FNBTDataAccessor NewAccessor;
     NewAccessor.Container = this->Container;
     NewAccessor.ContainerLiveToken = this->ContainerLiveToken;
-    NewAccessor.Path = this->Path;
-    NewAccessor.Path.Add(TVariant<FName, int32>(TInPlaceType<FName>(), Key));
+    NewAccessor.Path = this->Path.Child(Key);
 
-    if (CachedAttributePtr) {
-        if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    const FNBTAttribute* Attr = Container ? GetCachedAttribute() : nullptr;
+    if (Attr) {
+        if (auto* MapData = Attr->GetMapData()) {
             auto It = MapData->Children.Find(Key);
             if (It) {
                 NewAccessor.CachedAttributeID = *It;
                 NewAccessor.CachedContainerStructVersion = this->CachedContainerStructVersion;
-                NewAccessor.CachedAttributeVersionPtr = Container->GetAttributeVersion(NewAccessor.CachedAttributeID);
-                NewAccessor.CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(
-                    NewAccessor.CachedAttributeID);
+                InheritPathCache(NewAccessor, *It);
                 return NewAccessor;
             }
         }
@@ -33,18 +31,16 @@ FNBTDataAccessor FNBTDataAccessor::MakeAccessFromIntIndex(int32 Index) const {
 
     NewAccessor.Container = this->Container;
     NewAccessor.ContainerLiveToken = this->ContainerLiveToken;
-    NewAccessor.Path = this->Path;
-    NewAccessor.Path.Add(TVariant<FName, int32>(TInPlaceType<int32>(), Index));
+    NewAccessor.Path = this->Path.Child(Index);
 
-    if (CachedAttributePtr) {
-        if (auto* ListData = CachedAttributePtr->GetListData()) {
+    const FNBTAttribute* Attr = Container ? GetCachedAttribute() : nullptr;
+    if (Attr) {
+        if (auto* ListData = Attr->GetListData()) {
             if (ListData->Children.IsValidIndex(Index)) {
                 const auto& Data = ListData->Children[Index];
                 NewAccessor.CachedAttributeID = Data;
                 NewAccessor.CachedContainerStructVersion = this->CachedContainerStructVersion;
-                NewAccessor.CachedAttributeVersionPtr = Container->GetAttributeVersion(NewAccessor.CachedAttributeID);
-                NewAccessor.CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(
-                    NewAccessor.CachedAttributeID);
+                InheritPathCache(NewAccessor, Data);
                 return NewAccessor;
             }
         }
@@ -60,8 +56,7 @@ FNBTDataAccessor FNBTDataAccessor::GetParent() const {
     FNBTDataAccessor Parent;
     Parent.Container = this->Container;
     Parent.ContainerLiveToken = this->ContainerLiveToken;
-    Parent.Path = this->Path;
-    Parent.Path.RemoveAt(Parent.Path.Num() - 1);
+    Parent.Path = this->Path.GetParent();
 
     auto Res = Parent.ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Res != ENBTAttributeOpResult::Success) {
@@ -78,22 +73,14 @@ FNBTDataAccessor FNBTDataAccessor::GetParentPreview() const {
     FNBTDataAccessor Parent;
     Parent.Container = this->Container;
     Parent.ContainerLiveToken = this->ContainerLiveToken;
-    Parent.Path = this->Path;
-    Parent.Path.RemoveAt(Parent.Path.Num() - 1);
+    Parent.Path = this->Path.GetParent();
 
     return Parent;
 }
 
 bool FNBTDataAccessor::IsAncestor(const FNBTDataAccessor& P, const FNBTDataAccessor& C) {
     if (P.Container != C.Container) return false;
-    if (P.Path.Num() > C.Path.Num()) return false;
-    for (int i = 0; i < P.Path.Num(); ++i) {
-        const auto& a = P.Path[i];
-        const auto& b = C.Path[i];
-        if (a.GetIndex() != b.GetIndex()) return false;
-        if (a.IsType<FName>()) { if (a.Get<FName>() != b.Get<FName>()) return false; } else { if (a.Get<int32>() != b.Get<int32>()) return false; }
-    }
-    return true;
+    return P.Path.IsPrefixOf(C.Path);
 }
 
 bool FNBTDataAccessor::IsParent(const FNBTDataAccessor& OtherNode) const {
@@ -170,7 +157,7 @@ bool FNBTDataAccessor::IsEqual(const FNBTDataAccessor& Other) const {
     // 若同容器且同ID，必然相等（同一节点）
     if (Container == Other.Container && CachedAttributeID.IsValid() &&
         CachedAttributeID == Other.CachedAttributeID &&
-        CachedAttributePtr && Other.CachedAttributePtr) {
+        Container->IsAttributeValid(CachedAttributeID)) {
         return true;
     }
 
@@ -196,12 +183,12 @@ bool FNBTDataAccessor::IsDataExists() const {
 
 TOptional<ENBTAttributeType> FNBTDataAccessor::GetType() const {
     return IsDataExists()
-               ? TOptional<ENBTAttributeType>(CachedAttributePtr->GetType())
+               ? TOptional<ENBTAttributeType>(GetCachedAttribute()->GetType())
                : TOptional<ENBTAttributeType>();
 }
 
 FString FNBTDataAccessor::GetTypeString() const {
-    return IsDataExists() ? CachedAttributePtr->GetTypeString() : "!Type$Invalid Node$";
+    return IsDataExists() ? GetCachedAttribute()->GetTypeString() : "!Type$Invalid Node$";
 }
 
 bool FNBTDataAccessor::IsSubtreeChanged() const {
@@ -210,7 +197,7 @@ bool FNBTDataAccessor::IsSubtreeChanged() const {
         auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
         if (Result != ENBTAttributeOpResult::Success) return LastObservedSubtreeVersion != -1;
         if (LastObservedAttributeID != CachedAttributeID) return true;
-        if (CachedSubtreeVersionPtr && *CachedSubtreeVersionPtr != LastObservedSubtreeVersion) return true;
+        if (*GetCachedSubtreeVersion() != LastObservedSubtreeVersion) return true;
     }
     return false;
 }
@@ -223,9 +210,7 @@ bool FNBTDataAccessor::IsSubtreeChangedAndMark() const {
 
 void FNBTDataAccessor::MarkSubtree() const {
     if (IsDataExists()) {
-        if (CachedSubtreeVersionPtr) {
-            LastObservedSubtreeVersion = *CachedSubtreeVersionPtr;
-        }
+        LastObservedSubtreeVersion = *GetCachedSubtreeVersion();
         //LastObservedContainerDataVersion = Container->GetContainerDataVersion();
         LastObservedAttributeID = CachedAttributeID;
     } else {
@@ -247,7 +232,7 @@ bool FNBTDataAccessor::IsDataChanged() const {
 
     if (LastObservedAttributeID != CachedAttributeID) return true;
 
-    return *CachedAttributeVersionPtr != LastObservedNodeVersion;
+    return *GetCachedAttributeVersion() != LastObservedNodeVersion;
 }
 
 bool FNBTDataAccessor::IsDataChangedAndMark() const {
@@ -260,10 +245,9 @@ bool FNBTDataAccessor::IsDataChangedAndMark() const {
 void FNBTDataAccessor::Mark() const {
     if (IsDataExists()) {
         LastObservedAttributeID = CachedAttributeID;
-        LastObservedNodeVersion = *CachedAttributeVersionPtr;
+        LastObservedNodeVersion = *GetCachedAttributeVersion();
         LastObservedContainerDataVersion = Container->GetContainerDataVersion();
-        if (CachedSubtreeVersionPtr)
-            LastObservedSubtreeVersion = *CachedSubtreeVersionPtr;
+        LastObservedSubtreeVersion = *GetCachedSubtreeVersion();
     } else {
         LastObservedNodeVersion = -1;
         LastObservedContainerDataVersion = Container->GetContainerDataVersion();
@@ -283,13 +267,13 @@ bool FNBTDataAccessor::IsMap() const {
 
 bool FNBTDataAccessor::IsEmptyMap() const {
     if (!IsDataExists()) return false;
-    auto Ptr = CachedAttributePtr->GetMapData();
+    auto Ptr = GetCachedAttribute()->GetMapData();
     return Ptr && Ptr->Children.IsEmpty();
 }
 
 bool FNBTDataAccessor::IsFilledMap() const {
     if (!IsDataExists()) return false;
-    auto Ptr = CachedAttributePtr->GetMapData();
+    auto Ptr = GetCachedAttribute()->GetMapData();
     return Ptr && !Ptr->Children.IsEmpty();
 }
 
@@ -300,13 +284,13 @@ bool FNBTDataAccessor::IsList() const {
 
 bool FNBTDataAccessor::IsEmptyList() const {
     if (!IsDataExists()) return false;
-    auto Ptr = CachedAttributePtr->GetListData();
+    auto Ptr = GetCachedAttribute()->GetListData();
     return Ptr && Ptr->Children.IsEmpty();
 }
 
 bool FNBTDataAccessor::IsFilledList() const {
     if (!IsDataExists()) return false;
-    auto Ptr = CachedAttributePtr->GetListData();
+    auto Ptr = GetCachedAttribute()->GetListData();
     return Ptr && !Ptr->Children.IsEmpty();
 }
 
@@ -325,32 +309,15 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
 
     const auto CurrentContainerVersion = Container->GetContainerStructVersion();
 
+    // 缓存只有节点ID, 结构版本一致时只需确认槽位仍被同一代占用
     if (CachedContainerStructVersion == CurrentContainerVersion) {
-        if (CachedAttributeID.IsValid() && CachedAttributePtr && CachedAttributeVersionPtr && CachedSubtreeVersionPtr) {
+        if (Container->Allocator.IsNodeValid(CachedAttributeID)) {
             return ENBTAttributeOpResult::Success; //缓存有效
         }
-
-        CachedAttributePtr = Container->GetAttribute(CachedAttributeID);
-        if (CachedAttributePtr) {
-            CachedAttributeVersionPtr = Container->GetAttributeVersion(CachedAttributeID); // 依然有效
-            CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(CachedAttributeID);
-            if (CachedAttributeVersionPtr && CachedSubtreeVersionPtr) {
-                return ENBTAttributeOpResult::Success;
-            }
-        }
-    } else {
-        // 结构版本已变化，但ID可能仍然有效, 直接检查是不是InvalidIndex, 如果是InvalidIndex也不用尝试获取数据, 因为本身就是无效的
-        if (CachedAttributeID.IsValid()) {
-            CachedAttributePtr = Container->GetAttribute(CachedAttributeID);
-            if (CachedAttributePtr) {
-                CachedAttributeVersionPtr = Container->GetAttributeVersion(CachedAttributeID);
-                CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(CachedAttributeID);
-                if (CachedAttributeVersionPtr && CachedSubtreeVersionPtr) { // 依然有效
-                    CachedContainerStructVersion = CurrentContainerVersion;
-                    return ENBTAttributeOpResult::Success;
-                }
-            }
-        }
+    } else if (CachedAttributeID.IsValid() && FindResumeDepth() == Path.Num()) {
+        // 结构版本已变化, 只比较本路径上各祖先的结构版本: 都没变说明修改发生在无关子树, 节点仍在原位置
+        CachedContainerStructVersion = CurrentContainerVersion;
+        return ENBTAttributeOpResult::Success;
     }
 
     //否则进行重新构筑
@@ -369,24 +336,40 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
         return ENBTAttributeOpResult::InvalidID;
     }
 
+    FNBTPathNodeArray PathNodes;
+    Path.GetNodes(PathNodes);
+
+    // 从仍然有效的最深祖先继续解析, 而不是每次都从根开始
+    int32 StartDepth = FindResumeDepth();
+    if (StartDepth != INDEX_NONE) {
+        CurrentID = CachedPathIDs[StartDepth];
+    } else {
+        StartDepth = 0;
+        CachedPathIDs.SetNum(PathNodes.Num() + 1);
+        CachedPathStructVersions.SetNum(PathNodes.Num() + 1);
+        CachedPathIDs[0] = CurrentID;
+    }
+    for (int32 i = StartDepth + 1; i < CachedPathIDs.Num(); ++i) {
+        CachedPathIDs[i] = FNBTAttributeID();
+    }
+
     FNBTAttribute* CurrentAttr = Container->GetAttribute(CurrentID);
     int32* CurrentVersion = Container->GetAttributeVersion(CurrentID);
     int32* CurrentSubtreeVersion = Container->GetAttributeSubtreeVersion(CurrentID);
-    if (!CurrentAttr || !CurrentVersion || !CurrentSubtreeVersion) {
+    int32* CurrentStructVersion = Container->GetAttributeStructVersion(CurrentID);
+    if (!CurrentAttr || !CurrentVersion || !CurrentSubtreeVersion || !CurrentStructVersion) {
         return ENBTAttributeOpResult::InvalidID;
     }
 
     if (Path.Num() == 0) {
+        CachedPathStructVersions[0] = *CurrentStructVersion;
         CachedAttributeID = CurrentID;
-        CachedAttributePtr = CurrentAttr;
-        CachedAttributeVersionPtr = CurrentVersion;
         CachedContainerStructVersion = CurrentContainerVersion;
-        CachedSubtreeVersionPtr = CurrentSubtreeVersion;
         return ENBTAttributeOpResult::Success;
     }
 
-    for (int32 PathIndex = 0; PathIndex < Path.Num(); ++PathIndex) {
-        const auto& PathElement = Path[PathIndex];
+    for (int32 PathIndex = StartDepth; PathIndex < PathNodes.Num(); ++PathIndex) {
+        const auto& PathElement = PathNodes[PathIndex]->Segment;
 
         if (const FName* KeyPtr = PathElement.TryGet<FName>()) {
             // ===== Map路径处理 =====
@@ -402,13 +385,13 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
 
                 if (Mode == ENBTPathResolveMode::ForceOverride) {
                     Container->ReleaseChildren(CurrentID);
-                    CurrentAttr->OverrideToEmptyMap();
-                    (*CurrentVersion)++;
-                    UpdateContainerDataAndStructVersion();
+                    CurrentAttr->OverrideToEmptyMap(GetPayloadPool());
+                    Container->Allocator.BumpNodeVersion(CurrentID);
+                    UpdateContainerDataAndStructVersion(CurrentID);
                 } else if (Mode == ENBTPathResolveMode::EnsureCreate && CurrentAttr->IsEmpty()) {
-                    CurrentAttr->OverrideToEmptyMap();
-                    (*CurrentVersion)++;
-                    UpdateContainerDataAndStructVersion();
+                    CurrentAttr->OverrideToEmptyMap(GetPayloadPool());
+                    Container->Allocator.BumpNodeVersion(CurrentID);
+                    UpdateContainerDataAndStructVersion(CurrentID);
                 } else {
                     return {
                         ENBTAttributeOpResult::PermissionDenied,
@@ -441,8 +424,9 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
                 }
 
                 MapData->Children.Emplace(*KeyPtr, NewChildID);
-                (*CurrentVersion)++;
-                UpdateContainerDataAndStructVersion();
+                Container->Allocator.SetNodeParent(NewChildID, CurrentID);
+                Container->Allocator.BumpNodeVersion(CurrentID);
+                UpdateContainerDataAndStructVersion(CurrentID);
                 CurrentID = NewChildID;
             }
         } else if (const int32* IndexPtr = PathElement.TryGet<int32>()) {
@@ -462,13 +446,13 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
 
                 if (Mode == ENBTPathResolveMode::ForceOverride) {
                     Container->ReleaseChildren(CurrentID);
-                    CurrentAttr->OverrideToEmptyList();
-                    (*CurrentVersion)++;
-                    UpdateContainerDataAndStructVersion();
+                    CurrentAttr->OverrideToEmptyList(GetPayloadPool());
+                    Container->Allocator.BumpNodeVersion(CurrentID);
+                    UpdateContainerDataAndStructVersion(CurrentID);
                 } else if (Mode == ENBTPathResolveMode::EnsureCreate && CurrentAttr->IsEmpty()) {
-                    CurrentAttr->OverrideToEmptyList();
-                    (*CurrentVersion)++;
-                    UpdateContainerDataAndStructVersion();
+                    CurrentAttr->OverrideToEmptyList(GetPayloadPool());
+                    Container->Allocator.BumpNodeVersion(CurrentID);
+                    UpdateContainerDataAndStructVersion(CurrentID);
                 } else {
                     return {
                         ENBTAttributeOpResult::NodeTypeMismatch,
@@ -504,24 +488,58 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ResolvePathInternal(ENBTPathResolv
             return ENBTAttributeOpResult::InvalidContainer;
         }
 
+        CachedPathStructVersions[PathIndex] = *CurrentStructVersion; // 本层的修改已经完成
+
         CurrentAttr = Container->GetAttribute(CurrentID);
         CurrentVersion = Container->GetAttributeVersion(CurrentID);
         CurrentSubtreeVersion = Container->GetAttributeSubtreeVersion(CurrentID);
-        if (!CurrentAttr || !CurrentVersion || !CurrentSubtreeVersion) {
+        CurrentStructVersion = Container->GetAttributeStructVersion(CurrentID);
+        if (!CurrentAttr || !CurrentVersion || !CurrentSubtreeVersion || !CurrentStructVersion) {
             return ENBTAttributeOpResult::InvalidID;
         }
+        CachedPathIDs[PathIndex + 1] = CurrentID;
     }
+    CachedPathStructVersions[Path.Num()] = *CurrentStructVersion;
 
     // 更新缓存
     CachedAttributeID = CurrentID;
-    CachedAttributePtr = CurrentAttr;
-    CachedAttributeVersionPtr = CurrentVersion;
     CachedContainerStructVersion = CurrentContainerVersion;
-    CachedSubtreeVersionPtr = CurrentSubtreeVersion;
 
     return ENBTAttributeOpResult::Success;
 }
 
+// 缓存路径中仍可信的最深层: 该层节点有效, 且其上每一层祖先的结构版本与解析时一致(子表未变, 链接依然成立)
+// 缓存不可用或根已变化时返回 INDEX_NONE
+int32 FNBTDataAccessor::FindResumeDepth() const {
+    const int32 NumSegments = Path.Num();
+    if (CachedPathIDs.Num() != NumSegments + 1 || CachedPathStructVersions.Num() != NumSegments + 1) return INDEX_NONE;
+    if (!(CachedPathIDs[0] == Container->GetRootID())) return INDEX_NONE;
+
+    for (int32 i = 0; i < NumSegments; ++i) {
+        const int32* StructVersion = Container->GetAttributeStructVersion(CachedPathIDs[i]);
+        if (!StructVersion) return i - 1;
+        if (*StructVersion != CachedPathStructVersions[i]) return i;
+    }
+    return Container->IsAttributeValid(CachedPathIDs[NumSegments]) ? NumSegments : NumSegments - 1;
+}
+
+// 父访问器的路径缓存完整时, 子访问器直接继承, 不必从根重新解析
+void FNBTDataAccessor::InheritPathCache(FNBTDataAccessor& Child, FNBTAttributeID ChildID) const {
+    const int32 NumSegments = Path.Num();
+    if (CachedPathIDs.Num() != NumSegments + 1 || CachedPathStructVersions.Num() != NumSegments + 1) return;
+    if (!(CachedPathIDs[NumSegments] == CachedAttributeID)) return;
+
+    const int32* ParentStructVersion = Container->GetAttributeStructVersion(CachedAttributeID);
+    const int32* ChildStructVersion = Container->GetAttributeStructVersion(ChildID);
+    if (!ParentStructVersion || !ChildStructVersion) return;
+
+    Child.CachedPathIDs = CachedPathIDs;
+    Child.CachedPathIDs.Add(ChildID);
+    Child.CachedPathStructVersions = CachedPathStructVersions;
+    Child.CachedPathStructVersions[NumSegments] = *ParentStructVersion;
+    Child.CachedPathStructVersions.Add(*ChildStructVersion);
+}
+
 FString FNBTDataAccessor::GetPathString(int ToIndex) const {
     FString Result = "Root";
 
@@ -529,18 +547,21 @@ FString FNBTDataAccessor::GetPathString(int ToIndex) const {
 
     int idx = FMath::Clamp(ToIndex, 0, Path.Num() - 1);
 
+    FNBTPathNodeArray PathNodes;
+    Path.GetNodes(PathNodes);
     for (int i = 0; i <= idx; i++) {
         Result += " -> ";
-        if (const FName* name = Path[i].TryGet<FName>()) {
+        if (const FName* name = PathNodes[i]->Segment.TryGet<FName>()) {
             Result += name->ToString();
         } else {
-            Result += FString::Printf(TEXT("[%d]"), Path[i].Get<int32>());
+            Result += FString::Printf(TEXT("[%d]"), PathNodes[i]->Segment.Get<int32>());
         }
     }
     return Result;
 }
 
-void FNBTDataAccessor::UpdateContainerDataAndStructVersion() const {
+void FNBTDataAccessor::UpdateContainerDataAndStructVersion(FNBTAttributeID ChangedNodeID) const {
+    Container->UpdateNodeStructVersion(ChangedNodeID);
     Container->UpdateContainerDataAndStructVersion();
     CachedContainerStructVersion = Container->GetContainerStructVersion();
 }
@@ -552,51 +573,35 @@ void FNBTDataAccessor::UpdateContainerDataVersion() const {
 void FNBTDataAccessor::BubbleSubtreeVersionAlongPath() const {
     if (!IsContainerValid()) return;
 
-    // Depth==-1 表示完整路径
-    const int32 MaxDepth = Path.Num();
-
-    // 从根开始
-    FNBTAttributeID CurrentID = Container->GetRootID();
-    if (!CurrentID.IsValid()) return;
-
-    // 根也要++（子树包含自身）
-    Container->IncAttributeSubtreeVersion(CurrentID);
-
-    // 逐段下行
-    for (int32 i = 0; i < MaxDepth; ++i) {
-        FNBTAttribute* Attr = Container->GetAttribute(CurrentID);
-        if (!Attr) break;
+    // 目标存活时直接沿父链接向上, 不经过路径查找
+    if (Container->IsAttributeValid(CachedAttributeID)) {
+        Container->BubbleSubtreeVersion(CachedAttributeID);
+        return;
+    }
 
-        const TVariant<FName, int32>& Elem = Path[i];
+    // 目标不存在时从根逐段下行, 只冒泡到已经到达的最深节点
+    FNBTAttributeID DeepestID = Container->GetRootID();
+    if (!DeepestID.IsValid()) return;
 
-        if (const FName* Key = Elem.TryGet<FName>()) {
-            // Map
-            if (auto* Map = Attr->GetMapData()) {
-                auto it = Map->Children.Find(*Key);
-                if (!it) break;
-                CurrentID = *it;
-            } else { break; }
-        } else if (const int32* Index = Elem.TryGet<int32>()) {
-            // List
-            if (auto* List = Attr->GetListData()) {
-                if (!List->Children.IsValidIndex(*Index)) break;
-                CurrentID = List->Children[*Index];
-            } else { break; }
-        }
+    FNBTPathNodeArray PathNodes;
+    Path.GetNodes(PathNodes);
 
-        // 路径节点自增子树版本
-        Container->IncAttributeSubtreeVersion(CurrentID);
+    for (const FNBTPathNode* PathNode : PathNodes) {
+        const FNBTAttributeID ChildID = FindChildID(DeepestID, PathNode->Segment);
+        if (!ChildID.IsValid()) break;
+        DeepestID = ChildID;
     }
+    Container->BubbleSubtreeVersion(DeepestID);
 }
 
 FNBTDataAccessor::FNBTDataAccessor(const FNBTDataAccessor& Other) {
     Container = Other.Container;
     ContainerLiveToken = Other.ContainerLiveToken;
     Path = Other.Path;
+    CachedPathIDs = Other.CachedPathIDs;
+    CachedPathStructVersions = Other.CachedPathStructVersions;
     CachedAttributeID = Other.CachedAttributeID;
     CachedContainerStructVersion = Other.CachedContainerStructVersion;
-    CachedAttributePtr = Other.CachedAttributePtr;
-    CachedSubtreeVersionPtr = Other.CachedSubtreeVersionPtr;
     LastObservedSubtreeVersion = Other.LastObservedSubtreeVersion;
 }
 
@@ -605,10 +610,10 @@ FNBTDataAccessor& FNBTDataAccessor::operator=(const FNBTDataAccessor& Other) {
     Container = Other.Container;
     ContainerLiveToken = Other.ContainerLiveToken;
     Path = Other.Path;
+    CachedPathIDs = Other.CachedPathIDs;
+    CachedPathStructVersions = Other.CachedPathStructVersions;
     CachedAttributeID = Other.CachedAttributeID;
     CachedContainerStructVersion = Other.CachedContainerStructVersion;
-    CachedAttributePtr = Other.CachedAttributePtr;
-    CachedSubtreeVersionPtr = Other.CachedSubtreeVersionPtr;
     LastObservedSubtreeVersion = Other.LastObservedSubtreeVersion;
     return *this;
 }
@@ -621,17 +626,16 @@ FNBTDataAccessor::FNBTDataAccessor(FNBTDataAccessor&& Other) {
 
     Path = std::move(Other.Path);
 
+    CachedPathIDs = std::move(Other.CachedPathIDs);
+    CachedPathStructVersions = std::move(Other.CachedPathStructVersions);
+
     CachedAttributeID = Other.CachedAttributeID;
     Other.CachedAttributeID = FNBTAttributeID();
 
     CachedContainerStructVersion = Other.CachedContainerStructVersion;
     Other.CachedContainerStructVersion = -1;
 
-    CachedAttributePtr = Other.CachedAttributePtr;
-    Other.CachedAttributePtr = nullptr;
 
-    CachedSubtreeVersionPtr = Other.CachedSubtreeVersionPtr;
-    Other.CachedSubtreeVersionPtr = nullptr;
 
     LastObservedSubtreeVersion = Other.LastObservedSubtreeVersion;
     Other.LastObservedSubtreeVersion = -1;
@@ -647,17 +651,16 @@ FNBTDataAccessor& FNBTDataAccessor::operator=(FNBTDataAccessor&& Other) {
 
     Path = std::move(Other.Path);
 
+    CachedPathIDs = std::move(Other.CachedPathIDs);
+    CachedPathStructVersions = std::move(Other.CachedPathStructVersions);
+
     CachedAttributeID = Other.CachedAttributeID;
     Other.CachedAttributeID = FNBTAttributeID();
 
     CachedContainerStructVersion = Other.CachedContainerStructVersion;
     Other.CachedContainerStructVersion = -1;
 
-    CachedAttributePtr = Other.CachedAttributePtr;
-    Other.CachedAttributePtr = nullptr;
 
-    CachedSubtreeVersionPtr = Other.CachedSubtreeVersionPtr;
-    Other.CachedSubtreeVersionPtr = nullptr;
 
     LastObservedSubtreeVersion = Other.LastObservedSubtreeVersion;
     Other.LastObservedSubtreeVersion = -1;
@@ -668,13 +671,13 @@ FNBTDataAccessor& FNBTDataAccessor::operator=(FNBTDataAccessor&& Other) {
 TOptional<int64> FNBTDataAccessor::TryGetGenericInt() const {
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return {};
-    return CachedAttributePtr->GetGenericInt();
+    return GetCachedAttribute()->GetGenericInt();
 }
 
 TOptional<double> FNBTDataAccessor::TryGetGenericDouble() const {
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return {};
-    return CachedAttributePtr->GetGenericDouble();
+    return GetCachedAttribute()->GetGenericDouble();
 }
 
 TOptional<bool> FNBTDataAccessor::TryGetBool() const { return TryGet<bool>(); }
@@ -923,17 +926,17 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::EnsureAndSetEmpty() const {
     auto Result = ResolvePathInternal(ENBTPathResolveMode::EnsureCreate);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    if (CachedAttributePtr->IsEmpty()) {
+    if (GetCachedAttribute()->IsEmpty()) {
         return ENBTAttributeOpResult::SameAndNotChange;
     } else {
-        if (!CachedAttributePtr->IsCompoundType()) {
-            CachedAttributePtr->Reset();
-            (*CachedAttributeVersionPtr)++;
+        if (!GetCachedAttribute()->IsCompoundType()) {
+            GetCachedAttribute()->Reset(GetPayloadPool());
+            BumpCachedAttributeVersion();
             UpdateContainerDataVersion();
             BubbleSubtreeVersionAlongPath();
             return ENBTAttributeOpResult::Success;
         } else {
-            const auto Type = CachedAttributePtr->GetType();
+            const auto Type = GetCachedAttribute()->GetType();
             if (Type == ENBTAttributeType::List) {
                 return ListClear();
             } else if (Type == ENBTAttributeType::Map) {
@@ -948,10 +951,10 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetGenericInt(int64 Value) cons
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    Result = CachedAttributePtr->TrySetGenericInt(Value);
+    Result = GetCachedAttribute()->TrySetGenericInt(Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     }
@@ -963,10 +966,10 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetGenericDouble(double Value)
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    Result = CachedAttributePtr->TrySetGenericDouble(Value);
+    Result = GetCachedAttribute()->TrySetGenericDouble(Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     }
@@ -981,12 +984,12 @@ FNBTDataAccessor FNBTDataAccessor::EnsureMap() const {
     if (Result != ENBTAttributeOpResult::Success)
         return FNBTDataAccessor(nullptr, nullptr);;
 
-    if (CachedAttributePtr->GetType() == ENBTAttributeType::Map) {
+    if (GetCachedAttribute()->GetType() == ENBTAttributeType::Map) {
         return *this;
-    } else if (CachedAttributePtr->IsEmpty()) {
-        CachedAttributePtr->OverrideToEmptyMap();
-        (*CachedAttributeVersionPtr)++;
-        UpdateContainerDataAndStructVersion();
+    } else if (GetCachedAttribute()->IsEmpty()) {
+        GetCachedAttribute()->OverrideToEmptyMap(GetPayloadPool());
+        BumpCachedAttributeVersion();
+        UpdateContainerDataAndStructVersion(CachedAttributeID);
         BubbleSubtreeVersionAlongPath();
         return *this;
     }
@@ -998,17 +1001,17 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetEmpty() const {
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    if (CachedAttributePtr->IsEmpty()) {
+    if (GetCachedAttribute()->IsEmpty()) {
         return ENBTAttributeOpResult::SameAndNotChange;
     } else {
-        if (!CachedAttributePtr->IsCompoundType()) {
-            CachedAttributePtr->Reset();
-            (*CachedAttributeVersionPtr)++;
+        if (!GetCachedAttribute()->IsCompoundType()) {
+            GetCachedAttribute()->Reset(GetPayloadPool());
+            BumpCachedAttributeVersion();
             UpdateContainerDataVersion();
             BubbleSubtreeVersionAlongPath();
             return ENBTAttributeOpResult::Success;
         } else {
-            const auto Type = CachedAttributePtr->GetType();
+            const auto Type = GetCachedAttribute()->GetType();
             if (Type == ENBTAttributeType::List) {
                 return ListClear();
             } else if (Type == ENBTAttributeType::Map) {
@@ -1025,20 +1028,118 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapHasKey(FName Key) const {
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         return (MapData->Children.Find(Key))
                    ? ENBTAttributeOpResult::Success
                    : ENBTAttributeOpResult::NotFoundSubNode;
     } else return ENBTAttributeOpResult::NodeTypeMismatch;
 }
 
+FNBTAttributeID FNBTDataAccessor::FindChildID(FNBTAttributeID ParentID, const FNBTPathSegment& Segment) const {
+    const FNBTAttribute* Parent = Container->Allocator.FindLiveAttribute(ParentID);
+    if (!Parent) return FNBTAttributeID();
+
+    if (const FName* Key = Segment.TryGet<FName>()) {
+        if (const FNBTMapData* MapData = Parent->GetMapData()) {
+            if (const FNBTAttributeID* ChildID = MapData->Children.Find(*Key)) return *ChildID;
+        }
+    } else if (const int32* Index = Segment.TryGet<int32>()) {
+        if (const FNBTListData* ListData = Parent->GetListData()) {
+            if (ListData->Children.IsValidIndex(*Index)) return ListData->Children[*Index];
+        }
+    }
+    return FNBTAttributeID();
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetGenericIntBatch(const TArray<FName>& Keys, TArray<TOptional<int64>>& OutValues) const {
+    OutValues.Reset();
+    OutValues.SetNum(Keys.Num());
+    return MapVisitBatch(Keys, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetGenericInt();
+    });
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetGenericDoubleBatch(const TArray<FName>& Keys, TArray<TOptional<double>>& OutValues) const {
+    OutValues.Reset();
+    OutValues.SetNum(Keys.Num());
+    return MapVisitBatch(Keys, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetGenericDouble();
+    });
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetBoolBatch(const TArray<FName>& Keys, TArray<TOptional<bool>>& OutValues) const {
+    OutValues.SetNum(Keys.Num());
+    return MapTryGetBatch<bool>(Keys, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetInt32Batch(const TArray<FName>& Keys, TArray<TOptional<int32>>& OutValues) const {
+    OutValues.SetNum(Keys.Num());
+    return MapTryGetBatch<int32>(Keys, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetFloatBatch(const TArray<FName>& Keys, TArray<TOptional<float>>& OutValues) const {
+    OutValues.SetNum(Keys.Num());
+    return MapTryGetBatch<float>(Keys, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetNameBatch(const TArray<FName>& Keys, TArray<TOptional<FName>>& OutValues) const {
+    OutValues.SetNum(Keys.Num());
+    return MapTryGetBatch<FName>(Keys, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetStringBatch(const TArray<FName>& Keys, TArray<TOptional<FString>>& OutValues) const {
+    OutValues.SetNum(Keys.Num());
+    return MapTryGetBatch<FString>(Keys, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetGenericIntBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int64>>& OutValues) const {
+    OutValues.Reset();
+    OutValues.SetNum(RelativePaths.Num());
+    return VisitBatch(RelativePaths, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetGenericInt();
+    });
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetGenericDoubleBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<double>>& OutValues) const {
+    OutValues.Reset();
+    OutValues.SetNum(RelativePaths.Num());
+    return VisitBatch(RelativePaths, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetGenericDouble();
+    });
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetBoolBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<bool>>& OutValues) const {
+    OutValues.SetNum(RelativePaths.Num());
+    return TryGetBatch<bool>(RelativePaths, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetInt32Batch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int32>>& OutValues) const {
+    OutValues.SetNum(RelativePaths.Num());
+    return TryGetBatch<int32>(RelativePaths, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetFloatBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<float>>& OutValues) const {
+    OutValues.SetNum(RelativePaths.Num());
+    return TryGetBatch<float>(RelativePaths, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetNameBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FName>>& OutValues) const {
+    OutValues.SetNum(RelativePaths.Num());
+    return TryGetBatch<FName>(RelativePaths, OutValues);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetStringBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FString>>& OutValues) const {
+    OutValues.SetNum(RelativePaths.Num());
+    return TryGetBatch<FString>(RelativePaths, OutValues);
+}
+
 FNBTAttributeOpResultDetail FNBTDataAccessor::MapGetKeys(TArray<FName>& Keys) const {
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
 
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         Keys.Reset();
         for (const auto& Pair : MapData->Children) {
             Keys.Add(Pair.Key);
@@ -1054,7 +1155,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapGetSize(int32& Size) const {
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         Size = MapData->Children.Num();
         return ENBTAttributeOpResult::Success;
     } else return ENBTAttributeOpResult::NodeTypeMismatch;
@@ -1066,13 +1167,13 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapRemoveSubNode(FName Key) const
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         const auto Itor = MapData->Children.Find(Key);
         if (Itor) {
             if (Container->ReleaseRecursive(*Itor) > 0) {
                 MapData->Children.Remove(Key);
-                (*CachedAttributeVersionPtr)++;
-                UpdateContainerDataAndStructVersion();
+                BumpCachedAttributeVersion();
+                UpdateContainerDataAndStructVersion(CachedAttributeID);
                 BubbleSubtreeVersionAlongPath();
             }
             return ENBTAttributeOpResult::Success;
@@ -1090,10 +1191,10 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapClear() const {
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (CachedAttributePtr->GetMapData()) {
+    if (GetCachedAttribute()->GetMapData()) {
         if (Container->ReleaseChildren(CachedAttributeID) > 0) {
-            (*CachedAttributeVersionPtr)++;
-            UpdateContainerDataAndStructVersion();
+            BumpCachedAttributeVersion();
+            UpdateContainerDataAndStructVersion(CachedAttributeID);
             BubbleSubtreeVersionAlongPath();
         }
         return ENBTAttributeOpResult::Success;
@@ -1106,7 +1207,7 @@ FNBTDataAccessor FNBTDataAccessor::MapMakeAccessorByCondition(ENBTSearchConditio
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return FNBTDataAccessor();
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         switch (Condition) {
             case ENBTSearchCondition::IfEmpty: {
                 for (const auto& Pair : MapData->Children) {
@@ -1153,7 +1254,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapMakeAccessorsByCondition(
 
     Accessors.Reset();
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         switch (Condition) {
             case ENBTSearchCondition::IfEmpty: {
                 for (const auto& Pair : MapData->Children) {
@@ -1198,7 +1299,7 @@ FNBTDataAccessor FNBTDataAccessor::MapMakeAccessorByParameter(const FNBTSearchPa
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return FNBTDataAccessor();
 
-    const FNBTMapData* MapData = CachedAttributePtr ? CachedAttributePtr->GetMapData() : nullptr;
+    const FNBTMapData* MapData = GetCachedAttribute() ? GetCachedAttribute()->GetMapData() : nullptr;
     if (!MapData) return FNBTDataAccessor();
 
     // 1) 工具：大小写策略
@@ -1442,13 +1543,10 @@ FNBTDataAccessor FNBTDataAccessor::MapMakeAccessorByParameter(const FNBTSearchPa
         FNBTDataAccessor Out;
         Out.Container = this->Container;
         Out.ContainerLiveToken = this->ContainerLiveToken;
-        Out.Path = this->Path;
-        Out.Path.Add(TVariant<FName, int32>(TInPlaceType<FName>(), Key));
+        Out.Path = this->Path.Child(Key);
         Out.CachedAttributeID = ChildID;
         Out.CachedContainerStructVersion = this->CachedContainerStructVersion;
-        Out.CachedAttributeVersionPtr = Container->GetAttributeVersion(ChildID);
-        Out.CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(ChildID);
-        Out.CachedAttributePtr = Container->GetAttribute(ChildID);
+        InheritPathCache(Out, ChildID);
         return Out;
     };
 
@@ -1491,7 +1589,7 @@ FNBTDataAccessor FNBTDataAccessor::MapMakeAccessorIfEqual(const FNBTDataAccessor
 
     if (!Accessor.IsDataExists()) return {};
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         for (const auto& Pair : MapData->Children) {
             auto Attr = Container->GetAttribute(Pair.Value);
             if (!Attr) continue;
@@ -1512,7 +1610,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MapMakeAccessorsIfEqual(TArray<FNB
 
     Accessors.Reset();
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         for (const auto& Pair : MapData->Children) {
             if (EqualNodeDeep(Container, Pair.Value,
                               Accessor.Container, Accessor.CachedAttributeID))
@@ -1528,7 +1626,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MakeAccessorFromMap(TArray<FNBTDat
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* MapData = CachedAttributePtr->GetMapData()) {
+    if (auto* MapData = GetCachedAttribute()->GetMapData()) {
         Accessors.Reset();
         Accessors.Reserve(MapData->Children.Num());
         for (const auto& Pair : MapData->Children) {
@@ -1551,7 +1649,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListGetSize(int32& Size) const {
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         Size = ListData->Children.Num();
         return ENBTAttributeOpResult::Success;
     } else return ENBTAttributeOpResult::NodeTypeMismatch;
@@ -1565,11 +1663,11 @@ FNBTDataAccessor FNBTDataAccessor::ListAddSubNode() const {
         return FNBTDataAccessor(nullptr, nullptr); // 返回无效迭代器
     }
 
-    if (CachedAttributePtr->IsEmpty()) {
-        CachedAttributePtr->OverrideToEmptyList();
+    if (GetCachedAttribute()->IsEmpty()) {
+        GetCachedAttribute()->OverrideToEmptyList(GetPayloadPool());
     }
 
-    auto* ListData = CachedAttributePtr->GetListData();
+    auto* ListData = GetCachedAttribute()->GetListData();
     if (!ListData) {
         UE_LOG(NBTSystem, Warning, TEXT("Cannot add item to non-list attribute"));
         return FNBTDataAccessor(nullptr, nullptr); // 返回无效迭代器
@@ -1582,9 +1680,10 @@ FNBTDataAccessor FNBTDataAccessor::ListAddSubNode() const {
     }
 
     int32 NewIndex = ListData->Children.Add(NewID);
+    Container->Allocator.SetNodeParent(NewID, CachedAttributeID);
 
-    (*CachedAttributeVersionPtr)++;
-    UpdateContainerDataAndStructVersion();
+    BumpCachedAttributeVersion();
+    UpdateContainerDataAndStructVersion(CachedAttributeID);
     BubbleSubtreeVersionAlongPath();
 
     return MakeAccessFromIntIndex(NewIndex);
@@ -1595,7 +1694,7 @@ TOptional<int32> FNBTDataAccessor::ListGetCurrentIndex() const {
     if (Result != ENBTAttributeOpResult::Success)
         return {};
 
-    if (!Path.Last().IsType<int32>()) return {};
+    if (Path.IsRoot() || !Path.Last().IsType<int32>()) return {};
 
     return Path.Last().Get<int32>();
 }
@@ -1605,9 +1704,9 @@ TOptional<int32> FNBTDataAccessor::ListGetLastParentIndex() const {
     if (Result != ENBTAttributeOpResult::Success)
         return {};
 
-    for (int32 i = Path.Num() - 1; i >= 0; i--) {
-        if (Path[i].IsType<int32>()) {
-            return Path[i].Get<int32>();
+    for (const FNBTPathNode* Node = Path.GetNode(); Node; Node = Node->Parent.Get()) {
+        if (Node->Segment.IsType<int32>()) {
+            return Node->Segment.Get<int32>();
         }
     }
 
@@ -1619,7 +1718,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListRemoveSubNode(int32 Index, boo
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    auto* ListData = CachedAttributePtr->GetListData();
+    auto* ListData = GetCachedAttribute()->GetListData();
     if (!ListData) return ENBTAttributeOpResult::NodeTypeMismatch;
 
     if (!ListData->Children.IsValidIndex(Index))
@@ -1633,8 +1732,8 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListRemoveSubNode(int32 Index, boo
         ListData->Children.RemoveAt(Index);
 
     if (Container->ReleaseRecursive(ChildID) > 0) {
-        (*CachedAttributeVersionPtr)++;
-        UpdateContainerDataAndStructVersion();
+        BumpCachedAttributeVersion();
+        UpdateContainerDataAndStructVersion(CachedAttributeID);
         BubbleSubtreeVersionAlongPath();
     }
 
@@ -1646,12 +1745,12 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListClear() const {
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    auto* ListData = CachedAttributePtr->GetListData();
+    auto* ListData = GetCachedAttribute()->GetListData();
     if (!ListData) return ENBTAttributeOpResult::NodeTypeMismatch;
 
     if (Container->ReleaseChildren(CachedAttributeID) > 0) {
-        (*CachedAttributeVersionPtr)++;
-        UpdateContainerDataAndStructVersion();
+        BumpCachedAttributeVersion();
+        UpdateContainerDataAndStructVersion(CachedAttributeID);
         BubbleSubtreeVersionAlongPath();
     }
 
@@ -1665,7 +1764,7 @@ FNBTDataAccessor FNBTDataAccessor::ListInsertSubNode(int32 Index) const {
         return FNBTDataAccessor(nullptr, nullptr);
     }
 
-    auto* ListData = CachedAttributePtr->GetListData();
+    auto* ListData = GetCachedAttribute()->GetListData();
     if (!ListData) {
         UE_LOG(NBTSystem, Warning, TEXT("Cannot add item to non-list attribute"));
         return FNBTDataAccessor(nullptr, nullptr);
@@ -1685,9 +1784,10 @@ FNBTDataAccessor FNBTDataAccessor::ListInsertSubNode(int32 Index) const {
     }
 
     ListData->Children.Insert(NewID, Index);
+    Container->Allocator.SetNodeParent(NewID, CachedAttributeID);
 
-    (*CachedAttributeVersionPtr)++;
-    UpdateContainerDataAndStructVersion();
+    BumpCachedAttributeVersion();
+    UpdateContainerDataAndStructVersion(CachedAttributeID);
     BubbleSubtreeVersionAlongPath();
 
     return MakeAccessFromIntIndex(Index);
@@ -1697,7 +1797,7 @@ FNBTDataAccessor FNBTDataAccessor::ListMakeAccessorByCondition(ENBTSearchConditi
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success)
         return FNBTDataAccessor();
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         switch (Condition) {
             case ENBTSearchCondition::IfEmpty: {
                 for (int i = 0; i < ListData->Children.Num(); i++) {
@@ -1744,7 +1844,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListMakeAccessorsByCondition(
 
     Accessors.Reset();
 
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         switch (Condition) {
             case ENBTSearchCondition::IfEmpty: {
                 for (int i = 0; i < ListData->Children.Num(); i++) {
@@ -1790,7 +1890,7 @@ FNBTDataAccessor FNBTDataAccessor::ListMakeAccessorIfEqual(const FNBTDataAccesso
 
     if (!Accessor.IsDataExists()) return {};
 
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         for (int i = 0; i < ListData->Children.Num(); i++) {
             if (EqualNodeDeep(Container, ListData->Children[i],
                               Accessor.Container, Accessor.CachedAttributeID))
@@ -1810,7 +1910,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::ListMakeAccessorsIfEqual(TArray<FN
 
     Accessors.Reset();
 
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         for (int i = 0; i < ListData->Children.Num(); i++) {
             if (EqualNodeDeep(Container, ListData->Children[i],
                               Accessor.Container, Accessor.CachedAttributeID))
@@ -1826,7 +1926,7 @@ FNBTDataAccessor FNBTDataAccessor::ListMakeAccessorByParameter(const FNBTSearchP
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return FNBTDataAccessor();
 
-    const FNBTListData* ListData = CachedAttributePtr ? CachedAttributePtr->GetListData() : nullptr;
+    const FNBTListData* ListData = GetCachedAttribute() ? GetCachedAttribute()->GetListData() : nullptr;
     if (!ListData) return FNBTDataAccessor();
 
     const ESearchCase::Type SearchCase = P.IgnoreCase ? ESearchCase::IgnoreCase : ESearchCase::CaseSensitive;
@@ -2061,13 +2161,10 @@ FNBTDataAccessor FNBTDataAccessor::ListMakeAccessorByParameter(const FNBTSearchP
         FNBTDataAccessor Out;
         Out.Container = this->Container;
         Out.ContainerLiveToken = this->ContainerLiveToken;
-        Out.Path = this->Path;
-        Out.Path.Add(TVariant<FName, int32>(TInPlaceType<int32>(), Index));
+        Out.Path = this->Path.Child(Index);
         Out.CachedAttributeID = ChildID;
         Out.CachedContainerStructVersion = this->CachedContainerStructVersion;
-        Out.CachedAttributeVersionPtr = Container->GetAttributeVersion(ChildID);
-        Out.CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(ChildID);
-        Out.CachedAttributePtr = Container->GetAttribute(ChildID);
+        InheritPathCache(Out, ChildID);
         return Out;
     };
 
@@ -2103,7 +2200,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::MakeAccessorFromList(TArray<FNBTDa
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (auto* ListData = CachedAttributePtr->GetListData()) {
+    if (auto* ListData = GetCachedAttribute()->GetListData()) {
         Accessors.Reset();
         Accessors.Reserve(ListData->Children.Num());
         for (int i = 0; i < ListData->Children.Num(); i++) {
@@ -2127,18 +2224,64 @@ int FNBTDataAccessor::Remove() { // 删除当前节点
     if (Result != ENBTAttributeOpResult::Success) //当前节点本身就不存在
         return 0;
 
+    const FNBTAttributeID ParentID = Container->Allocator.GetNodeParent(CachedAttributeID); // 释放后父链接随之清除, 先记下
     int RemoveNum = Container->ReleaseRecursive(CachedAttributeID);
 
-    UpdateContainerDataAndStructVersion();
-    BubbleSubtreeVersionAlongPath();
+    UpdateContainerDataAndStructVersion(FNBTAttributeID()); // 节点已释放, 经过它的缓存路径自然失效
+    Container->BubbleSubtreeVersion(ParentID);
 
     CachedAttributeID = FNBTAttributeID();
-    CachedAttributePtr = nullptr;
-    CachedAttributeVersionPtr = nullptr;
-    CachedSubtreeVersionPtr = nullptr;
     return RemoveNum;
 }
 
+FNBTAttributeOpResultDetail FNBTDataAccessor::ResolveReplicateKey(FNBTAttributeID& OutMapID, FName& OutKey) const {
+    if (!IsContainerValid()) return ENBTAttributeOpResult::InvalidContainer;
+    if (Path.IsRoot() || !Path.Last().IsType<FName>()) {
+        return FNBTAttributeOpResultDetail(ENBTAttributeOpResult::NodeTypeMismatch, TEXT("Replicate condition can only be attached to a map key"));
+    }
+
+    FNBTDataAccessor Parent = GetParentPreview();
+    FNBTAttributeOpResultDetail Result = Parent.ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
+    if (Result != ENBTAttributeOpResult::Success) return Result;
+
+    OutMapID = Parent.CachedAttributeID;
+    OutKey = Path.Last().Get<FName>();
+    return ENBTAttributeOpResult::Success;
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::SetReplicatePolicyInternal(const FNBTReplicatePolicy& Policy) const {
+    FNBTAttributeID MapID;
+    FName Key;
+    FNBTAttributeOpResultDetail Result = ResolveReplicateKey(MapID, Key);
+    if (Result != ENBTAttributeOpResult::Success) return Result;
+    return Container->SetReplicatePolicy(MapID, Key, Policy);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::SetReplicateCondition(ENBTReplicateCondition Condition, int32 TeamID) const {
+    if (Condition == ENBTReplicateCondition::Custom) {
+        return FNBTAttributeOpResultDetail(ENBTAttributeOpResult::PermissionDenied, TEXT("Custom replicate condition requires a predicate, use SetReplicatePredicate"));
+    }
+    FNBTReplicatePolicy Policy;
+    Policy.Condition = Condition;
+    Policy.TeamID = TeamID;
+    return SetReplicatePolicyInternal(Policy);
+}
+
+FNBTAttributeOpResultDetail FNBTDataAccessor::SetReplicatePredicate(const FNBTReplicatePredicate& Predicate) const {
+    FNBTReplicatePolicy Policy;
+    Policy.Condition = ENBTReplicateCondition::Custom;
+    Policy.Predicate = Predicate;
+    return SetReplicatePolicyInternal(Policy);
+}
+
+ENBTReplicateCondition FNBTDataAccessor::GetReplicateCondition() const {
+    FNBTAttributeID MapID;
+    FName Key;
+    if (ResolveReplicateKey(MapID, Key) != ENBTAttributeOpResult::Success) return ENBTReplicateCondition::All;
+    const FNBTReplicatePolicy* Policy = Container->FindReplicatePolicy(MapID, Key);
+    return Policy ? Policy->Condition : ENBTReplicateCondition::All;
+}
+
 FString FNBTDataAccessor::ToString(bool bShowVersion) const {
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success)
@@ -2160,12 +2303,14 @@ FString FNBTDataAccessor::GetPath() const {
     if (Result != ENBTAttributeOpResult::Success)
         PathStr = "$Node Not Exist$ ";
 
-    for (int i = 0; i < Path.Num(); i++) {
+    FNBTPathNodeArray PathNodes;
+    Path.GetNodes(PathNodes);
+    for (const FNBTPathNode* Node : PathNodes) {
         PathStr += " -> ";
-        if (Path[i].GetIndex() == 0) {
-            PathStr += Path[i].Get<FName>().ToString();
+        if (Node->Segment.GetIndex() == 0) {
+            PathStr += Node->Segment.Get<FName>().ToString();
         } else {
-            PathStr += FString::FromInt(Path[i].Get<int32>());
+            PathStr += FString::FromInt(Node->Segment.Get<int32>());
         }
     }
 
@@ -2175,12 +2320,14 @@ FString FNBTDataAccessor::GetPath() const {
 FString FNBTDataAccessor::GetPreviewPath() const {
     if (!IsAccessorValid()) return "$IsAccessorValid$";
     FString PathStr = "Root";
-    for (int i = 0; i < Path.Num(); i++) {
+    FNBTPathNodeArray PathNodes;
+    Path.GetNodes(PathNodes);
+    for (const FNBTPathNode* Node : PathNodes) {
         PathStr += " -> ";
-        if (Path[i].GetIndex() == 0) {
-            PathStr += Path[i].Get<FName>().ToString();
+        if (Node->Segment.GetIndex() == 0) {
+            PathStr += Node->Segment.Get<FName>().ToString();
         } else {
-            PathStr += FString::FromInt(Path[i].Get<int32>());
+            PathStr += FString::FromInt(Node->Segment.Get<int32>());
         }
     }
     return PathStr;
@@ -2207,7 +2354,7 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySwap(const FNBTDataAccessor& Ta
     if (Result != ENBTAttributeOpResult::Success)
         return Result;
 
-    if (CachedAttributePtr == Target.CachedAttributePtr)
+    if (GetCachedAttribute() == Target.GetCachedAttribute())
         return ENBTAttributeOpResult::Success;
 
     if (Container == Target.Container && CachedAttributeID == Target.CachedAttributeID)
@@ -2271,7 +2418,10 @@ bool FNBTDataAccessor::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSu
         uint32 Count = static_cast<uint32>(Path.Num());
         Ar.SerializeIntPacked(Count);
 
-        for (const TVariant<FName, int32>& V : Path) {
+        FNBTPathNodeArray PathNodes;
+        Path.GetNodes(PathNodes);
+        for (const FNBTPathNode* Node : PathNodes) {
+            const FNBTPathSegment& V = Node->Segment;
             const uint8 Tag = V.IsType<FName>() ? 0 : 1;
             Ar << const_cast<uint8&>(Tag);
 
@@ -2321,7 +2471,7 @@ bool FNBTDataAccessor::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSu
             return true;
         }
 
-        Path.Empty(Count);
+        Path.Reset();
 
         for (uint32 i = 0; i < Count; ++i) {
             uint8 Tag = 0;
@@ -2330,11 +2480,11 @@ bool FNBTDataAccessor::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSu
             if (Tag == 0) {
                 FName N;
                 Ar << N;
-                Path.Emplace(TVariant<FName, int32>(TInPlaceType<FName>(), N));
+                Path = Path.Child(N);
             } else if (Tag == 1) {
                 int32 I = 0;
                 Ar << I;
-                Path.Emplace(TVariant<FName, int32>(TInPlaceType<int32>(), I));
+                Path = Path.Child(I);
             } else {
                 UE_LOG(NBTSystem, Warning, TEXT("NBTDataAccessor::NetSerialize(recv): Invalid tag %u at index %u"), Tag, i);
                 return true;
@@ -2349,6 +2499,7 @@ bool FNBTDataAccessor::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSu
 
 ENBTAttributeOpResult FNBTDataAccessor::RedirectNode(FNBTAttributeID OldID, FNBTAttributeID NewID) const {
     bool bRepointed = false;
+    FNBTAttributeID ParentID;
 
     if (Path.Num() == 0) {
         Container->RootID = NewID;
@@ -2357,7 +2508,8 @@ ENBTAttributeOpResult FNBTDataAccessor::RedirectNode(FNBTAttributeID OldID, FNBT
         auto ParentAccessor = GetParent();
         if (!ParentAccessor.IsDataExists()) return ENBTAttributeOpResult::InvalidID;
 
-        auto ParentAttr = Container->GetAttribute(ParentAccessor.CachedAttributeID);
+        ParentID = ParentAccessor.CachedAttributeID;
+        auto ParentAttr = Container->GetAttribute(ParentID);
         if (!ParentAttr) return ENBTAttributeOpResult::InvalidID;
 
         if (const FName* Key = Path.Last().TryGet<FName>()) {
@@ -2365,7 +2517,7 @@ ENBTAttributeOpResult FNBTDataAccessor::RedirectNode(FNBTAttributeID OldID, FNBT
             if (!MapData) return ENBTAttributeOpResult::NodeTypeMismatch;
             if (FNBTAttributeID* Slot = MapData->Children.Find(*Key)) {
                 *Slot = NewID;
-                (*ParentAccessor.CachedAttributeVersionPtr)++;
+                Container->Allocator.BumpNodeVersion(ParentID);
                 bRepointed = true;
             } else {
                 return ENBTAttributeOpResult::NotFoundSubNode;
@@ -2376,7 +2528,7 @@ ENBTAttributeOpResult FNBTDataAccessor::RedirectNode(FNBTAttributeID OldID, FNBT
             if (!ListData->Children.IsValidIndex(*Index)) return ENBTAttributeOpResult::NotFoundSubNode;
 
             ListData->Children[*Index] = NewID;
-            (*ParentAccessor.CachedAttributeVersionPtr)++;
+            Container->Allocator.BumpNodeVersion(ParentID);
             bRepointed = true;
         } else {
             check(false);
@@ -2385,16 +2537,12 @@ ENBTAttributeOpResult FNBTDataAccessor::RedirectNode(FNBTAttributeID OldID, FNBT
     }
 
     CachedAttributeID = NewID;
-    CachedAttributePtr = Container->GetAttribute(NewID);
-    CachedAttributeVersionPtr = Container->GetAttributeVersion(NewID);
-    CachedSubtreeVersionPtr = Container->GetAttributeSubtreeVersion(NewID);
+    Container->Allocator.SetNodeParent(NewID, ParentID); // 根节点的父链接为无效ID
 
-    if (CachedAttributeVersionPtr) {
-        (*CachedAttributeVersionPtr)++;
-    }
+    BumpCachedAttributeVersion();
 
     if (bRepointed) {
-        UpdateContainerDataAndStructVersion();
+        UpdateContainerDataAndStructVersion(ParentID);
     } else {
         check(false);
         UpdateContainerDataVersion(); // 不应该到达这里
@@ -2422,15 +2570,15 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::EnsureAndCopyFrom(const FNBTDataAc
 }
 
 ENBTAttributeOpResult FNBTDataAccessor::CopyImp(const FNBTDataAccessor& Source) const {
-    if (CachedAttributePtr == Source.CachedAttributePtr)
+    if (GetCachedAttribute() == Source.GetCachedAttribute())
         return ENBTAttributeOpResult::Success;
 
-    if (!CachedAttributePtr->IsCompoundType() && !Source.CachedAttributePtr->IsCompoundType()) {
-        auto& PtrA = *CachedAttributePtr;
-        auto& PtrB = *Source.CachedAttributePtr;
-        auto const OpResult = PtrA.OverrideFromIfNotCompound(PtrB);
+    if (!GetCachedAttribute()->IsCompoundType() && !Source.GetCachedAttribute()->IsCompoundType()) {
+        auto& PtrA = *GetCachedAttribute();
+        auto& PtrB = *Source.GetCachedAttribute();
+        auto const OpResult = PtrA.OverrideFromIfNotCompound(GetPayloadPool(), PtrB);
         if (OpResult == ENBTAttributeOpResult::Success) { //还可能返回Same, 但是返回Same则说明数据没有改变, 不可能返回其他错误
-            (*CachedAttributeVersionPtr)++;
+            BumpCachedAttributeVersion();
             UpdateContainerDataVersion();
             BubbleSubtreeVersionAlongPath();
         }
@@ -2454,12 +2602,12 @@ FNBTDataAccessor FNBTDataAccessor::EnsureList() const {
     if (Result != ENBTAttributeOpResult::Success)
         return FNBTDataAccessor(nullptr, nullptr);
 
-    if (CachedAttributePtr->GetType() == ENBTAttributeType::List) {
+    if (GetCachedAttribute()->GetType() == ENBTAttributeType::List) {
         return *this;
-    } else if (CachedAttributePtr->IsEmpty()) {
-        CachedAttributePtr->OverrideToEmptyList();
-        (*CachedAttributeVersionPtr)++;
-        UpdateContainerDataAndStructVersion();
+    } else if (GetCachedAttribute()->IsEmpty()) {
+        GetCachedAttribute()->OverrideToEmptyList(GetPayloadPool());
+        BumpCachedAttributeVersion();
+        UpdateContainerDataAndStructVersion(CachedAttributeID);
         BubbleSubtreeVersionAlongPath();
         return *this;
     }
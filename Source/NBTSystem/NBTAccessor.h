@@ -3,6 +3,7 @@
 #include "NBTAttribute.h"
 #include "NBTAttributeID.h"
 #include "NBTContainer.h"
+#include "NBTPath.h"
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
 
@@ -10,6 +11,7 @@
 
 struct FNBTContainer;
 struct FNBTDataAccessor;
+struct FNBTCompiledPath;
 
 enum class ENBTPathResolveMode : uint8 {
 	ReadOnly, // 只读访问
@@ -24,14 +26,12 @@ struct FNBTDataAccessor {
 private:
 	FNBTContainer* Container = nullptr;
 	TWeakPtr<uint8> ContainerLiveToken = nullptr;
-	TArray<TVariant<FName, int32>> Path{};
+	FNBTPath Path{}; // 驻留路径, 拷贝与创建子路径均为O(1)
+	mutable TArray<FNBTAttributeID, TInlineAllocator<8>> CachedPathIDs; // 上次解析时每一层的节点ID, 下标0为根
+	mutable TArray<int32, TInlineAllocator<8>> CachedPathStructVersions; // 与 CachedPathIDs 对应, 离开该层时节点的结构版本
 	mutable FNBTAttributeID CachedAttributeID = FNBTAttributeID();
 	mutable int32 CachedContainerStructVersion = -1;
     
-	mutable FNBTAttribute* CachedAttributePtr = nullptr;
-	mutable int32* CachedAttributeVersionPtr = nullptr;
-    mutable int32* CachedSubtreeVersionPtr = nullptr;
-    
 	mutable int32 LastObservedNodeVersion = -1;
 	mutable int32 LastObservedContainerDataVersion = -1;
     mutable int32 LastObservedSubtreeVersion = -1;
@@ -39,30 +39,48 @@ private:
 private:
 	FNBTAttributeOpResultDetail ResolvePathInternal(ENBTPathResolveMode Mode) const;
 
+	int32 FindResumeDepth() const;
+
+	void InheritPathCache(FNBTDataAccessor& Child, FNBTAttributeID ChildID) const;
+
+	FNBTAttributeID FindChildID(FNBTAttributeID ParentID, const FNBTPathSegment& Segment) const;
+
 	FString GetPathString(int ToIndex) const;
 
-	void UpdateContainerDataAndStructVersion() const;
+	void UpdateContainerDataAndStructVersion(FNBTAttributeID ChangedNodeID) const;
 
     void UpdateContainerDataVersion() const;
 
     void BubbleSubtreeVersionAlongPath() const;
 
+    FNBTPayloadPool& GetPayloadPool() const { return Container->GetPayloadPool(); }
+
+    // 缓存只保存节点ID(块号/槽位/代数), 用到时按ID重新定位, 块被整理搬移或回收复用后不会留下悬空指针
+    // 解析成功后调用, 此时必定非空
+    FORCEINLINE FNBTAttribute* GetCachedAttribute() const { return Container->Allocator.FindLiveAttribute(CachedAttributeID); }
+    FORCEINLINE int32* GetCachedAttributeVersion() const { return Container->Allocator.FindLiveVersion(CachedAttributeID); }
+    FORCEINLINE void BumpCachedAttributeVersion() const { Container->Allocator.BumpNodeVersion(CachedAttributeID); }
+    FORCEINLINE int32* GetCachedSubtreeVersion() const {
+        Container->FlushSubtreeVersions(); // 延迟模式下先传播未处理的写入
+        return Container->Allocator.FindLiveSubtreeVersion(CachedAttributeID);
+    }
+
     bool EqualNodeDeep(const FNBTContainer* ACont, FNBTAttributeID AID,
                                   const FNBTContainer* BCont, FNBTAttributeID BID) const ;
 
 	friend struct FNBTContainer;
 
+	friend class FNBTSchemaView;
+
     void ResetAll() {
         Container = nullptr;
         ContainerLiveToken = nullptr;
         Path.Reset();
+        CachedPathIDs.Reset();
+        CachedPathStructVersions.Reset();
         CachedAttributeID = FNBTAttributeID();
         CachedContainerStructVersion = -1;
     
-        CachedAttributePtr = nullptr;
-        CachedAttributeVersionPtr = nullptr;
-        CachedSubtreeVersionPtr = nullptr;
-    
         LastObservedNodeVersion = -1;
         LastObservedContainerDataVersion = -1;
         LastObservedSubtreeVersion = -1;
@@ -347,6 +365,41 @@ public:
 	FNBTAttributeOpResultDetail MakeAccessorFromMap(TArray<FNBTDataAccessor>& Accessors) const;
 	TArray<FNBTDataAccessor> MakeAccessorFromMapNow() const;
 
+	// ========== 批量读取 ==========
+	// 当前节点只解析一次, 之后直接在其子表中查找; 输出由调用方提供, 不做逐项分配
+	// 不存在或类型不匹配的项为空, 当前节点本身无法解析时返回对应错误且所有输出为空
+
+	// Visitor(int32 Index, const FNBTAttribute* Attr), Attr 为空表示该项不存在
+	template <typename Func>
+	FNBTAttributeOpResultDetail MapVisitBatch(TArrayView<const FName> Keys, Func&& Visitor) const;
+	// 相对路径版本: 相邻路径的公共前缀(驻留节点相同)只解析一次, 路径按前缀排序时效果最好
+	template <typename Func>
+	FNBTAttributeOpResultDetail VisitBatch(TArrayView<const FNBTCompiledPath> RelativePaths, Func&& Visitor) const;
+
+	// OutValues 长度必须不小于 Keys/RelativePaths
+	template <typename T>
+	FNBTAttributeOpResultDetail MapTryGetBatch(TArrayView<const FName> Keys, TArrayView<TOptional<T>> OutValues) const;
+	template <typename T>
+	FNBTAttributeOpResultDetail TryGetBatch(TArrayView<const FNBTCompiledPath> RelativePaths, TArrayView<TOptional<T>> OutValues) const;
+
+	// 脚本用特化, OutValues 会被调整为与 Keys 等长, 复用同一数组时不再分配
+	FNBTAttributeOpResultDetail MapTryGetGenericIntBatch(const TArray<FName>& Keys, TArray<TOptional<int64>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetGenericDoubleBatch(const TArray<FName>& Keys, TArray<TOptional<double>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetBoolBatch(const TArray<FName>& Keys, TArray<TOptional<bool>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetInt32Batch(const TArray<FName>& Keys, TArray<TOptional<int32>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetFloatBatch(const TArray<FName>& Keys, TArray<TOptional<float>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetNameBatch(const TArray<FName>& Keys, TArray<TOptional<FName>>& OutValues) const;
+	FNBTAttributeOpResultDetail MapTryGetStringBatch(const TArray<FName>& Keys, TArray<TOptional<FString>>& OutValues) const;
+
+	// 脚本用相对路径版本, OutValues 调整为与 RelativePaths 等长
+	FNBTAttributeOpResultDetail TryGetGenericIntBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int64>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetGenericDoubleBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<double>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetBoolBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<bool>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetInt32Batch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int32>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetFloatBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<float>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetNameBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FName>>& OutValues) const;
+	FNBTAttributeOpResultDetail TryGetStringBatch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FString>>& OutValues) const;
+
 	// ========== List操作 ==========
 
 	FNBTAttributeOpResultDetail ListGetSize(int32& Size) const;
@@ -373,6 +426,14 @@ public:
 	FString GetPath() const;
 	FString GetPreviewPath() const;
 
+	// ========== 子树同步条件 ==========
+
+	// 条件挂在当前路径的最后一个Map键上, 作用于键下的整个子树; 键所在的Map必须存在, 键本身可以暂不存在
+	// All 表示移除条件; Custom 需要判定委托, 使用 SetReplicatePredicate
+	FNBTAttributeOpResultDetail SetReplicateCondition(ENBTReplicateCondition Condition, int32 TeamID = INDEX_NONE) const;
+	FNBTAttributeOpResultDetail SetReplicatePredicate(const FNBTReplicatePredicate& Predicate) const;
+	ENBTReplicateCondition GetReplicateCondition() const;
+
 	// 如果当前路径无效, 那么就不拷贝
     FNBTAttributeOpResultDetail TryCopyFrom(const FNBTDataAccessor& Source) const;
     
@@ -387,24 +448,18 @@ public:
     bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
 
     bool operator==(const FNBTDataAccessor& Other) const {
-        if (Path.Num() != Other.Path.Num()) return false;
-        for (int32 i = 0; i < Path.Num(); ++i) {
-            const auto& A = Path[i];
-            const auto& B = Other.Path[i];
-            if (A.GetIndex() != B.GetIndex()) return false;
-            if (A.GetIndex() == 0) {
-                if (A.Get<FName>() != B.Get<FName>()) return false;
-            } else { // int32
-                if (A.Get<int32>() != B.Get<int32>()) return false;
-            }
-        }
-
+        if (Path != Other.Path) return false; // 驻留路径, 指针相等即路径相等
         return ContainerLiveToken.Pin().Get() == Other.ContainerLiveToken.Pin().Get();
     }
 
 private:
 
     ENBTAttributeOpResult RedirectNode(FNBTAttributeID OldID, FNBTAttributeID NewID) const;
+
+    // 解析同步条件挂载的位置: 父Map节点与最后一段的键
+    FNBTAttributeOpResultDetail ResolveReplicateKey(FNBTAttributeID& OutMapID, FName& OutKey) const;
+
+    FNBTAttributeOpResultDetail SetReplicatePolicyInternal(const FNBTReplicatePolicy& Policy) const;
     
 	template <typename Func>
 	void VisitDataImp(int32& Deep, FName AttrName, int idx, FNBTDataAccessor TargetAccessor, Func DataVisitor) const;
@@ -3,19 +3,98 @@
 #include "NBTAccessor.h"
 #include "NBTContainer.h"
 #include "NBTAttribute.h"
+#include "NBTCompiledPath.h"
 
 template <typename T>
 TOptional<T> FNBTDataAccessor::TryGet() const {
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return {};
-    return CachedAttributePtr->GetBaseType<T>();
+    return GetCachedAttribute()->GetBaseType<T>();
 }
 
 template <typename T>
 const TArray<T>* FNBTDataAccessor::TryGetArray() const {
     if (ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success)
         return {};
-    return CachedAttributePtr->GetArrayType<T>();
+    return GetCachedAttribute()->GetArrayType<T>();
+}
+
+template <typename Func>
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapVisitBatch(TArrayView<const FName> Keys, Func&& Visitor) const {
+    auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
+    if (Result != ENBTAttributeOpResult::Success) return Result;
+
+    const FNBTMapData* MapData = GetCachedAttribute()->GetMapData();
+    if (!MapData) return ENBTAttributeOpResult::NodeTypeMismatch;
+
+    for (int32 i = 0; i < Keys.Num(); ++i) {
+        const FNBTAttributeID* ChildID = MapData->Children.Find(Keys[i]);
+        Visitor(i, ChildID ? Container->Allocator.FindLiveAttribute(*ChildID) : nullptr);
+    }
+    return ENBTAttributeOpResult::Success;
+}
+
+template <typename Func>
+FNBTAttributeOpResultDetail FNBTDataAccessor::VisitBatch(TArrayView<const FNBTCompiledPath> RelativePaths, Func&& Visitor) const {
+    auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
+    if (Result != ENBTAttributeOpResult::Success) return Result;
+
+    // 上一条路径逐层解析到的节点, 下标0为当前节点; 只保存成功解析的层
+    FNBTPathNodeArray PrevNodes;
+    TArray<FNBTAttributeID, TInlineAllocator<16>> PrevIDs;
+    PrevIDs.Add(CachedAttributeID);
+
+    FNBTPathNodeArray Nodes;
+    for (int32 i = 0; i < RelativePaths.Num(); ++i) {
+        const FNBTCompiledPath& RelativePath = RelativePaths[i];
+        if (!RelativePath.IsValid()) {
+            Visitor(i, nullptr);
+            continue;
+        }
+
+        Nodes.Reset();
+        RelativePath.GetPath().GetNodes(Nodes);
+
+        int32 Shared = 0;
+        const int32 MaxShared = FMath::Min(PrevNodes.Num(), PrevIDs.Num() - 1);
+        while (Shared < MaxShared && Shared < Nodes.Num() && Nodes[Shared] == PrevNodes[Shared]) {
+            ++Shared;
+        }
+        PrevIDs.SetNum(Shared + 1);
+
+        FNBTAttributeID CurrentID = PrevIDs[Shared];
+        for (int32 Depth = Shared; Depth < Nodes.Num(); ++Depth) {
+            CurrentID = FindChildID(CurrentID, Nodes[Depth]->Segment);
+            if (!CurrentID.IsValid()) break;
+            PrevIDs.Add(CurrentID);
+        }
+        PrevNodes = Nodes;
+
+        Visitor(i, PrevIDs.Num() == Nodes.Num() + 1 ? Container->Allocator.FindLiveAttribute(CurrentID) : nullptr);
+    }
+    return ENBTAttributeOpResult::Success;
+}
+
+template <typename T>
+FNBTAttributeOpResultDetail FNBTDataAccessor::MapTryGetBatch(TArrayView<const FName> Keys, TArrayView<TOptional<T>> OutValues) const {
+    check(OutValues.Num() >= Keys.Num());
+    for (TOptional<T>& Value : OutValues) {
+        Value.Reset();
+    }
+    return MapVisitBatch(Keys, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetBaseType<T>();
+    });
+}
+
+template <typename T>
+FNBTAttributeOpResultDetail FNBTDataAccessor::TryGetBatch(TArrayView<const FNBTCompiledPath> RelativePaths, TArrayView<TOptional<T>> OutValues) const {
+    check(OutValues.Num() >= RelativePaths.Num());
+    for (TOptional<T>& Value : OutValues) {
+        Value.Reset();
+    }
+    return VisitBatch(RelativePaths, [&OutValues](int32 Index, const FNBTAttribute* Attr) {
+        if (Attr) OutValues[Index] = Attr->GetBaseType<T>();
+    });
 }
 
 template <typename T>
@@ -23,14 +102,14 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetBaseType(T Value) const {
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    Result = CachedAttributePtr->TrySetBaseType(Value);
+    Result = GetCachedAttribute()->TrySetBaseType(Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     } else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -40,14 +119,14 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetBaseTypeRef(const T& Value)
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    Result = CachedAttributePtr->TrySetBaseTypeRef(Value);
+    Result = GetCachedAttribute()->TrySetBaseTypeRef(Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     } else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -57,14 +136,14 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::TrySetArray(const TArray<T>& Value
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ReadOnly);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    Result = CachedAttributePtr->TrySetArrayType<T>(Value);
+    Result = GetCachedAttribute()->TrySetArrayType<T>(Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     } else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -74,18 +153,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::EnsureAndSetBaseType(T Value) cons
     auto Result = ResolvePathInternal(ENBTPathResolveMode::EnsureCreate);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    if (CachedAttributePtr->IsEmpty()) {
-        Result = CachedAttributePtr->OverriderToBaseType<T>(Value);
+    if (GetCachedAttribute()->IsEmpty()) {
+        Result = GetCachedAttribute()->OverriderToBaseType<T>(GetPayloadPool(), Value);
     } else {
-        Result = CachedAttributePtr->TrySetBaseType<T>(Value);
+        Result = GetCachedAttribute()->TrySetBaseType<T>(Value);
     }
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     }  else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -95,18 +174,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::EnsureAndSetBaseTypeRef(const T& V
     auto Result = ResolvePathInternal(ENBTPathResolveMode::EnsureCreate);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    if (CachedAttributePtr->IsEmpty()) {
-        Result = CachedAttributePtr->OverriderToBaseTypeRef<T>(Value);
+    if (GetCachedAttribute()->IsEmpty()) {
+        Result = GetCachedAttribute()->OverriderToBaseTypeRef<T>(GetPayloadPool(), Value);
     } else {
-        Result = CachedAttributePtr->TrySetBaseTypeRef<T>(Value);
+        Result = GetCachedAttribute()->TrySetBaseTypeRef<T>(Value);
     }
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     }  else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -116,18 +195,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::EnsureAndSetArray(const TArray<T>&
     auto Result = ResolvePathInternal(ENBTPathResolveMode::EnsureCreate);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    if (CachedAttributePtr->IsEmpty()) {
-        Result = CachedAttributePtr->OverriderToArrayType<T>(Value);
+    if (GetCachedAttribute()->IsEmpty()) {
+        Result = GetCachedAttribute()->OverriderToArrayType<T>(GetPayloadPool(), Value);
     } else {
-        Result = CachedAttributePtr->TrySetArrayType<T>(Value);
+        Result = GetCachedAttribute()->TrySetArrayType<T>(Value);
     }
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         UpdateContainerDataVersion();
         BubbleSubtreeVersionAlongPath();
     } else if (Result != ENBTAttributeOpResult::SameAndNotChange) {
-        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *CachedAttributePtr->GetTypeString());
+        Result.ResultMessage = FString::Printf(TEXT("Node [%s] : is %s."), *GetPathString(Path.Num()), *GetCachedAttribute()->GetTypeString());
     }
     return Result;
 }
@@ -137,18 +216,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::OverrideToBaseType(T Value) const
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ForceOverride);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    const bool bWasCompoundType = CachedAttributePtr->IsCompoundType();
+    const bool bWasCompoundType = GetCachedAttribute()->IsCompoundType();
 
     if (bWasCompoundType) { //如果是复合结构, 那么先移除所有子项
         Container->ReleaseChildren(CachedAttributeID);
     }
 
-    Result = CachedAttributePtr->OverriderToBaseType(Value);
+    Result = GetCachedAttribute()->OverriderToBaseType(GetPayloadPool(), Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         if (bWasCompoundType) {
-            UpdateContainerDataAndStructVersion();
+            UpdateContainerDataAndStructVersion(CachedAttributeID);
             BubbleSubtreeVersionAlongPath();
         } else {
             UpdateContainerDataVersion();
@@ -163,18 +242,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::OverrideToBaseTypeRef(const T& Val
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ForceOverride);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    const bool bWasCompoundType = CachedAttributePtr->IsCompoundType();
+    const bool bWasCompoundType = GetCachedAttribute()->IsCompoundType();
 
     if (bWasCompoundType) { //如果是复合结构, 那么先移除所有子项
         Container->ReleaseChildren(CachedAttributeID);
     }
 
-    Result = CachedAttributePtr->OverriderToBaseTypeRef(Value);
+    Result = GetCachedAttribute()->OverriderToBaseTypeRef(GetPayloadPool(), Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         if (bWasCompoundType) {
-            UpdateContainerDataAndStructVersion();
+            UpdateContainerDataAndStructVersion(CachedAttributeID);
             BubbleSubtreeVersionAlongPath();
         } else {
             UpdateContainerDataVersion();
@@ -189,18 +268,18 @@ FNBTAttributeOpResultDetail FNBTDataAccessor::OverrideToArray(const TArray<T>& V
     auto Result = ResolvePathInternal(ENBTPathResolveMode::ForceOverride);
     if (Result != ENBTAttributeOpResult::Success) return Result;
 
-    const bool bWasCompoundType = CachedAttributePtr->IsCompoundType();
+    const bool bWasCompoundType = GetCachedAttribute()->IsCompoundType();
 
     if (bWasCompoundType) { //如果是复合结构, 那么先移除所有子项
         Container->ReleaseChildren(CachedAttributeID);
     }
 
-    Result = CachedAttributePtr->OverriderToArrayType<T>(Value);
+    Result = GetCachedAttribute()->OverriderToArrayType<T>(GetPayloadPool(), Value);
 
     if (Result == ENBTAttributeOpResult::Success) {
-        (*CachedAttributeVersionPtr)++;
+        BumpCachedAttributeVersion();
         if (bWasCompoundType) {
-            UpdateContainerDataAndStructVersion();
+            UpdateContainerDataAndStructVersion(CachedAttributeID);
             BubbleSubtreeVersionAlongPath();
         } else {
             UpdateContainerDataVersion();
@@ -216,7 +295,7 @@ void FNBTDataAccessor::VisitData(Func DataVisitor) const {
     if (Result != ENBTAttributeOpResult::Success)
         return;
 
-    if (!CachedAttributePtr)
+    if (!GetCachedAttribute())
         return;
 
     int Deep = 0;
@@ -226,10 +305,10 @@ void FNBTDataAccessor::VisitData(Func DataVisitor) const {
 template <typename Func>
 void FNBTDataAccessor::VisitDataImp(int32& Deep, FName AttrName, int idx, FNBTDataAccessor TargetAccessor,
     Func DataVisitor) const {
-    const ENBTAttributeType Type = CachedAttributePtr->GetType();
+    const ENBTAttributeType Type = GetCachedAttribute()->GetType();
 
     if (Type == ENBTAttributeType::Map) {
-        auto* MapData = CachedAttributePtr->GetMapData();
+        auto* MapData = GetCachedAttribute()->GetMapData();
         if (!MapData)
             return;
         DataVisitor(Deep, Type, AttrName, idx, TargetAccessor);
@@ -242,7 +321,7 @@ void FNBTDataAccessor::VisitDataImp(int32& Deep, FName AttrName, int idx, FNBTDa
         }
         Deep--;
     } else if (Type == ENBTAttributeType::List) {
-        auto* ListData = CachedAttributePtr->GetListData();
+        auto* ListData = GetCachedAttribute()->GetListData();
         if (!ListData)
             return;
         DataVisitor(Deep, Type, AttrName, idx, TargetAccessor);
@@ -3,18 +3,36 @@
 #include "CoreMinimal.h"
 #include "NBTAttribute.h"
 #include "NBTAttributeID.h"
+#include "NBTPayloadPool.h"
+#include "NBTChunkPool.h"
 #include "HAL/UnrealMemory.h"
 
 #define ARZ_NBT_CHUNK_SIZE 64
 
+// 热数据: 占用位/代/版本/子树版本/结构版本/父节点, 每种字段各自是连续数组
+// 版本检查与网络差分只扫描这一块, 不触碰属性负载
 struct FNBTAttributeChunkMetaData {
     uint64 UsedMask {};
-    uint16 Generations[ARZ_NBT_CHUNK_SIZE] {};
+    FNBTAttributeID::GenerationType Generations[ARZ_NBT_CHUNK_SIZE] {};
     int32 Versions[ARZ_NBT_CHUNK_SIZE] {};
     int32 SubtreeVersions[ARZ_NBT_CHUNK_SIZE] {};
+    int32 StructVersions[ARZ_NBT_CHUNK_SIZE] {}; // 节点自身的结构版本: 子项增删/重定向/类型改变时自增, 访问器沿路径比较
+    FNBTAttributeID Parents[ARZ_NBT_CHUNK_SIZE] {}; // 父节点ID, 子树版本沿此向上冒泡; 根节点与游离节点为无效ID
     uint8 UsedCount {};
+#if ARZ_NBT_WIDE_ID
+    uint8 Padding[3] {};
+    uint32 ChunkIndex {};
+#else
     uint16 ChunkIndex {};
     uint8 Padding[5] {};
+#endif
+};
+
+// 块编号的代数/结构版本高水位: 块被裁剪或随 Reset(true) 归还块池时保存, 同一编号重建时恢复
+// 否则重建的块从零代开始, 会重新发出整理前已经用过的 (索引, 代数) 与较小的结构版本
+struct FNBTChunkSlotWatermark {
+    FNBTAttributeID::GenerationType Generations[ARZ_NBT_CHUNK_SIZE] {};
+    int32 StructVersions[ARZ_NBT_CHUNK_SIZE] {};
 };
 
 enum class FAttributeChunkAllocateAtResult : uint8 {
@@ -24,26 +42,72 @@ enum class FAttributeChunkAllocateAtResult : uint8 {
     NewOne      // 新对象
 };
 
-struct alignas(64) FAttributeChunk {
-    
+// 冷数据: 属性负载, 与元数据分开分配
+struct alignas(64) FNBTAttributeChunkPayload {
     uint8 AttributeBuffer[sizeof(FNBTAttribute) * ARZ_NBT_CHUNK_SIZE];
+};
+
+struct alignas(64) FAttributeChunk {
 
     FNBTAttributeChunkMetaData Meta;
 
-    FAttributeChunk(uint16 Index) {
-        FMemory::Memzero(this, sizeof(FAttributeChunk));
-        Meta.ChunkIndex = Index;
+    TUniquePtr<FNBTAttributeChunkPayload> Payload;
+
+    FNBTPayloadPool* PayloadPool; // 所属分配器的负载侧池
+
+    FAttributeChunk(uint32 Index, FNBTPayloadPool* InPayloadPool, const FNBTChunkSlotWatermark* Watermark) : Payload(MakeUnique<FNBTAttributeChunkPayload>()), PayloadPool(InPayloadPool) {
+        Meta.ChunkIndex = static_cast<decltype(Meta.ChunkIndex)>(Index);
+        SeedFromWatermark(Watermark);
     }
 
     ~FAttributeChunk() {
-        if (Meta.UsedMask != 0) {
-            FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(AttributeBuffer);
-            for (uint32 i = 0; i < ARZ_NBT_CHUNK_SIZE; ++i) {
-                if (Meta.UsedMask & (1ULL << i)) {
-                    Attributes[i].~FNBTAttribute();
-                }
+        ReleaseAllSlots(false);
+    }
+
+    // 从块池中取出复用时调用, 块内必须已经没有节点
+    // 块可能来自其他容器, 代数与结构版本不沿用池中的值, 而是取自新所属分配器为该编号保存的高水位
+    void Reinitialize(uint32 Index, FNBTPayloadPool* InPayloadPool, const FNBTChunkSlotWatermark* Watermark) {
+        check(Meta.UsedMask == 0);
+        Meta.UsedMask = 0;
+        Meta.UsedCount = 0;
+        FMemory::Memzero(Meta.Versions, sizeof(Meta.Versions));
+        FMemory::Memzero(Meta.SubtreeVersions, sizeof(Meta.SubtreeVersions));
+        for (FNBTAttributeID& Parent : Meta.Parents) { Parent = FNBTAttributeID(); }
+        Meta.ChunkIndex = static_cast<decltype(Meta.ChunkIndex)>(Index);
+        SeedFromWatermark(Watermark);
+        PayloadPool = InPayloadPool;
+    }
+
+    // 该编号从未被所属分配器使用过时 Watermark 为空, 从零开始
+    void SeedFromWatermark(const FNBTChunkSlotWatermark* Watermark) {
+        if (Watermark) {
+            FMemory::Memcpy(Meta.Generations, Watermark->Generations, sizeof(Meta.Generations));
+            FMemory::Memcpy(Meta.StructVersions, Watermark->StructVersions, sizeof(Meta.StructVersions));
+        } else {
+            FMemory::Memzero(Meta.Generations, sizeof(Meta.Generations));
+            FMemory::Memzero(Meta.StructVersions, sizeof(Meta.StructVersions));
+        }
+    }
+
+    // 析构块内所有节点, bArenaTeardown 时池内负载块留给竞技场整体释放, 字符串/数组等自带堆缓冲区的负载仍逐个析构
+    // 只遍历已占用的槽位, 标量等平凡负载直接跳过; 保留代数, 旧ID在槽位复用后依然失效
+    void ReleaseAllSlots(bool bArenaTeardown) {
+        uint64 Remaining = Meta.UsedMask;
+        if (Remaining == 0) return;
+        FNBTAttribute* Attributes = GetAttributes();
+        while (Remaining != 0) {
+            const uint32 i = static_cast<uint32>(FMath::CountTrailingZeros64(Remaining));
+            Remaining &= Remaining - 1;
+            FNBTAttribute& Attribute = Attributes[i];
+            if (Attribute.IsTriviallyReleasable()) continue;
+            if (bArenaTeardown) {
+                Attribute.ReleaseForArenaTeardown(*PayloadPool);
+            } else {
+                Attribute.Release(*PayloadPool);
             }
         }
+        Meta.UsedMask = 0;
+        Meta.UsedCount = 0;
     }
 
     int32* GetVersion(uint16 LocalIndex) {
@@ -56,9 +120,18 @@ struct alignas(64) FAttributeChunk {
         return &Meta.SubtreeVersions[LocalIndex];
     }
 
+    int32* GetStructVersion(uint16 LocalIndex) {
+        if (!IsIndexValid(LocalIndex)) return nullptr;
+        return &Meta.StructVersions[LocalIndex];
+    }
+
     FNBTAttribute* GetAttribute(uint16 LocalIndex) {
         if (!IsIndexValid(LocalIndex)) return nullptr;
-        return reinterpret_cast<FNBTAttribute*>(AttributeBuffer) + LocalIndex;
+        return GetAttributes() + LocalIndex;
+    }
+
+    FORCEINLINE FNBTAttribute* GetAttributes() const {
+        return reinterpret_cast<FNBTAttribute*>(Payload->AttributeBuffer);
     }
     
     // 分配槽位
@@ -73,31 +146,36 @@ struct alignas(64) FAttributeChunk {
         Meta.Generations[LocalIndex]++;
         Meta.Versions[LocalIndex] = 0;
         Meta.SubtreeVersions[LocalIndex] = 0;
-        FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(AttributeBuffer);
+        Meta.StructVersions[LocalIndex]++; // 不清零, 槽位复用后旧的缓存版本也不会碰巧相等
+        Meta.Parents[LocalIndex] = FNBTAttributeID();
+        FNBTAttribute* Attributes = GetAttributes();
         new(&Attributes[LocalIndex]) FNBTAttribute();
         
         return LocalIndex;
     }
 
     // 确定性分配, 指定index和generation, 给网络同步使用
-    FAttributeChunkAllocateAtResult AllocateSlotAt(uint16 LocalIndex, uint16 ExpectedGeneration) {
+    FAttributeChunkAllocateAtResult AllocateSlotAt(uint16 LocalIndex, FNBTAttributeID::GenerationType ExpectedGeneration) {
         if (!IsInRange(LocalIndex)) return FAttributeChunkAllocateAtResult::Failed;
         if (IsUsed(LocalIndex)) {
             Meta.Versions[LocalIndex] ++; // Hack Op, 用于客户端检测数据更新
+            Meta.StructVersions[LocalIndex]++; // 客户端无法区分子表是否变化, 保守地视为结构修改
             //Meta.SubtreeVersions[LocalIndex] = 0;
             if (Meta.Generations[LocalIndex] == ExpectedGeneration) return FAttributeChunkAllocateAtResult::Exist;
-            FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(AttributeBuffer);
-            Attributes[LocalIndex].~FNBTAttribute();
+            FNBTAttribute* Attributes = GetAttributes();
+            Attributes[LocalIndex].Release(*PayloadPool);
             Meta.Generations[LocalIndex] = ExpectedGeneration;
-            new(&Attributes[LocalIndex]) FNBTAttribute();
+            Meta.Parents[LocalIndex] = FNBTAttributeID(); // 已是另一个节点, 由父节点的子表重新链接
             return FAttributeChunkAllocateAtResult::Replaced;
         } else {
             Meta.UsedMask |= (1ULL << LocalIndex);
             Meta.UsedCount++;
             Meta.Generations[LocalIndex] = ExpectedGeneration;
             Meta.Versions[LocalIndex]++; // Hack Op, 用于客户端检测数据更新
+            Meta.StructVersions[LocalIndex]++;
+            Meta.Parents[LocalIndex] = FNBTAttributeID();
             //Meta.SubtreeVersions[LocalIndex] = 0;
-            FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(AttributeBuffer);
+            FNBTAttribute* Attributes = GetAttributes();
             new(&Attributes[LocalIndex]) FNBTAttribute();
             return FAttributeChunkAllocateAtResult::NewOne;
         }
@@ -105,12 +183,13 @@ struct alignas(64) FAttributeChunk {
     }
 
     // 释放槽位
-    bool DeallocateSlot(uint16 LocalIndex, uint16 ExpectedGeneration) {
+    bool DeallocateSlot(uint16 LocalIndex, FNBTAttributeID::GenerationType ExpectedGeneration) {
         if (!IsIndexValid(LocalIndex)) return false;
         if (Meta.Generations[LocalIndex] != ExpectedGeneration) return false;
 
-        // 调用析构函数
-        FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(AttributeBuffer);
+        // 释放负载并调用析构函数
+        FNBTAttribute* Attributes = GetAttributes();
+        Attributes[LocalIndex].Release(*PayloadPool);
         Attributes[LocalIndex].~FNBTAttribute();
 
         // 标记为未使用
@@ -118,6 +197,7 @@ struct alignas(64) FAttributeChunk {
         Meta.UsedCount--;
         Meta.Versions[LocalIndex] = 0;
         Meta.SubtreeVersions[LocalIndex] = 0;
+        Meta.Parents[LocalIndex] = FNBTAttributeID();
         return true;
     }
 
@@ -142,16 +222,29 @@ struct alignas(64) FAttributeChunk {
     }
 };
 
+// 块的所有权: 释放时归还到进程级块池
+struct FNBTChunkDeleter {
+    void operator()(FAttributeChunk* Chunk) const {
+        FNBTChunkPool::Get().Release(Chunk);
+    }
+};
+
+using FAttributeChunkPtr = TUniquePtr<FAttributeChunk, FNBTChunkDeleter>;
+
 struct FNBTAllocator {
     static constexpr uint32 CHUNK_SIZE = ARZ_NBT_CHUNK_SIZE;
     static constexpr uint32 CHUNK_SHIFT = 6; // log2(64)
     static constexpr uint32 CHUNK_MASK = 0x3F; // 63
-    static constexpr uint16 MAX_CHUNKS = 1024; // 64 * 1024 = 65536 总节点数
+    static constexpr uint32 MAX_CHUNKS = (1U << FNBTAttributeID::IndexBits) >> CHUNK_SHIFT; // 窄模式 1024 * 64 = 65536, 宽模式 262144 * 64 = 16777216
+    static constexpr uint32 MAX_ACTIVE_NODES = FNBTAttributeID::MaxNodes;
 private:
     friend class FArzNBTContainerBaseState;
+
+    // 负载侧池, 必须先于Chunks构造、晚于Chunks析构
+    mutable FNBTPayloadPool PayloadPool;
     
     // 块管理
-    TArray<TUniquePtr<FAttributeChunk>> Chunks;
+    TArray<FAttributeChunkPtr> Chunks;
 
     // 统计信息
     struct {
@@ -161,34 +254,75 @@ private:
         uint32 PeakActive = 0;
     } Stats;
 
-    uint16 RoundRobinIndex = 0;
+    uint32 RoundRobinIndex = 0;
+
+    // 空闲块索引: 以UsedCount(0~63)分桶的侵入式双向链表, 满块不入桶
+    // 最高的非空桶即为"最密且有空位"的块, 选择代价为O(1)
+    static constexpr uint8 NOT_IN_BUCKET = 0xFF;
+
+    struct FChunkBucketLink {
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        uint8 Bucket = NOT_IN_BUCKET;
+    };
+
+    TArray<FChunkBucketLink> ChunkLinks; // 与Chunks一一对应
+
+    int32 BucketHeads[ARZ_NBT_CHUNK_SIZE];
+
+    uint64 NonEmptyBucketMask = 0; // 第i位表示占用数为i的桶非空
+
+    // 块变更戳: 影响网络差分的修改(节点数据版本自增/分配/释放/新建块)把所在块的戳设为变更时钟的新值
+    // 快照记录当时的时钟, 差分时戳不大于快照时钟的块必然未变; 各连接的基线不同, 用单调戳代替需要逐连接清除的脏位图
+    uint64 ChangeClock = 0;
+
+    TArray<uint64> ChunkChangeStamps; // 与Chunks一一对应, 连续存放, 扫描时不触碰元数据
+
+    TArray<FNBTChunkSlotWatermark> ChunkWatermarks; // 按块编号, 只记录释放过块的编号, 不随 Reset 清除
 
 public:
     FNBTAllocator() {
+        ResetFreeChunkIndex();
         AllocateNewChunk();
     }
 
-    ~FNBTAllocator() = default;
+    ~FNBTAllocator() {
+        ReleaseAllNodes();
+    }
 
-    void Reset() {
-        Chunks.Empty();
+    // 清空所有节点, 默认保留块内存供后续复用, bReleaseChunkMemory 时才把块还给系统
+    void Reset(bool bReleaseChunkMemory = false) {
+        ReleaseAllNodes();
         Stats.TotalAllocated = 0;
         Stats.TotalDeallocated = 0;
         Stats.CurrentActive = 0;
         Stats.PeakActive = 0;
         RoundRobinIndex = 0;
-        AllocateNewChunk();
+        ResetFreeChunkIndex();
+        if (bReleaseChunkMemory || Chunks.Num() == 0) {
+            for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex) {
+                SaveChunkWatermark(ChunkIndex); // 块归还块池后, 重建的同编号块仍从这里的代数继续
+            }
+            Chunks.Empty();
+            ChunkChangeStamps.Empty();
+            AllocateNewChunk();
+            return;
+        }
+        ChunkLinks.SetNum(Chunks.Num());
+        for (int32 ChunkIndex = Chunks.Num() - 1; ChunkIndex >= 0; --ChunkIndex) {
+            LinkChunkToBucket(ChunkIndex); // 逆序入桶, 0号块位于桶头, 根节点重新落在0号块
+        }
     }
 
     // 分配属性
     FNBTAttributeID Allocate() {
         //分配满了就不分配了, 在正常使用中, 这个几乎是不可能的, 不存在这么大的NBT, 如果存在, 那么整个程序会陷入大麻烦.
-        if (Stats.CurrentActive >= 65534) {
-            UE_LOG(NBTSystem, Error, TEXT("NBT Allocator full! (65534 nodes)")); // 序列65535用于有效性校验
+        if (Stats.CurrentActive >= MAX_ACTIVE_NODES) {
+            UE_LOG(NBTSystem, Error, TEXT("NBT Allocator full! (%u nodes)"), MAX_ACTIVE_NODES); // 最后一个序列用于有效性校验
             return FNBTAttributeID();
         }
         
-        uint16 ChunkIndex = SelectOrCreateChunkForBestAllocation(); // 根据策略选择块, 该函数自己会智能分配
+        uint32 ChunkIndex = SelectOrCreateChunkForBestAllocation(); // 根据策略选择块, 该函数自己会智能分配
         FAttributeChunk* Chunk = Chunks[ChunkIndex].Get();
         
         auto AllocateResult = Chunks[ChunkIndex]->AllocateSlot();
@@ -196,9 +330,11 @@ public:
             UE_LOG(NBTSystem, Error, TEXT("NBT Allocator AllocateSlot Logic Failed"));
             return FNBTAttributeID();
         }
+        RefreshChunkBucket(ChunkIndex);
+        MarkChunkChanged(ChunkIndex);
         
         uint16 LocalIndex = AllocateResult.GetValue();
-        uint16 GlobalIndex = (ChunkIndex << CHUNK_SHIFT) | LocalIndex;
+        FNBTAttributeID::IndexType GlobalIndex = static_cast<FNBTAttributeID::IndexType>((ChunkIndex << CHUNK_SHIFT) | LocalIndex);
 
         // 更新统计
         Stats.TotalAllocated++;
@@ -206,7 +342,7 @@ public:
         Stats.PeakActive = FMath::Max(Stats.PeakActive, Stats.CurrentActive);
 
         // 生成ID
-        uint16 Generation = Chunk->Meta.Generations[LocalIndex];
+        FNBTAttributeID::GenerationType Generation = Chunk->Meta.Generations[LocalIndex];
         return FNBTAttributeID(GlobalIndex, Generation);
     }
 
@@ -214,10 +350,10 @@ public:
     FNBTAttribute* AllocateAt(FNBTAttributeID ID) {
         if (!ID.IsValid()) return nullptr;
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
 
-        if (ChunkIndex >= MAX_CHUNKS) {
+        if (ChunkIndex >= static_cast<int32>(MAX_CHUNKS)) {
             UE_LOG(NBTSystem, Error, TEXT("NBT Allocator out of bounds! Cannot AllocateAt ID %s"), *ID.ToString());
             return nullptr;
         }
@@ -227,17 +363,21 @@ public:
         FAttributeChunk* Chunk = Chunks[ChunkIndex].Get();
        
         const auto Result = Chunk->AllocateSlotAt(LocalIndex, ID.Generation);
+        if (Result != FAttributeChunkAllocateAtResult::Failed) {
+            MarkChunkChanged(ChunkIndex);
+        }
         
         if (Result == FAttributeChunkAllocateAtResult::Exist) {
-            return reinterpret_cast<FNBTAttribute*>(Chunk->AttributeBuffer) + LocalIndex;
+            return Chunk->GetAttributes() + LocalIndex;
         } else if (Result == FAttributeChunkAllocateAtResult::NewOne) {
+            RefreshChunkBucket(ChunkIndex);
             Stats.TotalAllocated++;
             Stats.CurrentActive++;
             Stats.PeakActive = FMath::Max(Stats.PeakActive, Stats.CurrentActive);
-            return reinterpret_cast<FNBTAttribute*>(Chunk->AttributeBuffer) + LocalIndex;
+            return Chunk->GetAttributes() + LocalIndex;
         } else if (Result == FAttributeChunkAllocateAtResult::Replaced) {
             Stats.TotalAllocated++;
-            return reinterpret_cast<FNBTAttribute*>(Chunk->AttributeBuffer) + LocalIndex;
+            return Chunk->GetAttributes() + LocalIndex;
         }
         
         return nullptr;
@@ -247,12 +387,14 @@ public:
     bool Deallocate(FNBTAttributeID ID) {
         if (!ID.IsValid()) return false;
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
         
         if (!Chunks.IsValidIndex(ChunkIndex)) return false;
 
         if (Chunks[ChunkIndex]->DeallocateSlot(LocalIndex, ID.Generation)) {
+            RefreshChunkBucket(ChunkIndex);
+            MarkChunkChanged(ChunkIndex);
             // 更新统计
             Stats.TotalDeallocated++;
             Stats.CurrentActive--;
@@ -266,7 +408,7 @@ public:
     int32* GetNodeVersion(FNBTAttributeID ID) const {
         if (!ID.IsValid()) return nullptr;
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
 
         if (ChunkIndex >= Chunks.Num()) return nullptr;
@@ -281,7 +423,7 @@ public:
         
         if (!ID.IsValid()) return nullptr;
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
 
         if (ChunkIndex >= Chunks.Num()) return nullptr;
@@ -292,18 +434,84 @@ public:
         return Chunk->GetSubtreeVersion(LocalIndex);
     }
 
+    // 节点数据版本自增, 同时标记所在块已变更; 所有数据版本的修改都经过这里
+    void BumpNodeVersion(FNBTAttributeID ID) {
+        uint32 LocalIndex;
+        if (FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex)) {
+            Chunk->Meta.Versions[LocalIndex]++;
+            MarkChunkChanged(ID.Index >> CHUNK_SHIFT);
+        }
+    }
+
     void IncNodeSubtreeVersion(FNBTAttributeID ID) const {
         if (int32* P = GetNodeSubtreeVersion(ID)) { ++(*P); }
     }
 
-    bool IsNodeValid(FNBTAttributeID ID) const {
-        if (!ID.IsValid()) return false;
+    int32* GetNodeStructVersion(FNBTAttributeID ID) const {
+        if (!ID.IsValid()) return nullptr;
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
 
-        if (ChunkIndex >= Chunks.Num()) return false;
-        return Chunks[ChunkIndex]->IsIndexValid(LocalIndex);
+        if (ChunkIndex >= Chunks.Num()) return nullptr;
+
+        FAttributeChunk* Chunk = Chunks[ChunkIndex].Get();
+        if (Chunk->Meta.Generations[LocalIndex] != ID.Generation) return nullptr;
+
+        return Chunk->GetStructVersion(LocalIndex);
+    }
+
+    void IncNodeStructVersion(FNBTAttributeID ID) const {
+        if (int32* P = GetNodeStructVersion(ID)) { ++(*P); }
+    }
+
+    // 句柄定位: ID 即(块号, 槽位, 代数), 每次按ID重新找到所在块, 不保存任何块内指针
+    // 槽位占用与代数检查合并为一次分支, 不记录日志; 无效ID的块号必然越界或落在永不分配的末尾槽位
+    FORCEINLINE FAttributeChunk* FindLiveChunk(FNBTAttributeID ID, uint32& OutLocalIndex) const {
+        const uint32 ChunkIndex = static_cast<uint32>(ID.Index) >> CHUNK_SHIFT;
+        OutLocalIndex = static_cast<uint32>(ID.Index) & CHUNK_MASK;
+        if (ChunkIndex >= static_cast<uint32>(Chunks.Num())) return nullptr;
+
+        FAttributeChunk* Chunk = Chunks[ChunkIndex].Get();
+        const bool bLive = (((Chunk->Meta.UsedMask >> OutLocalIndex) & 1ULL) != 0) & (Chunk->Meta.Generations[OutLocalIndex] == ID.Generation);
+        return bLive ? Chunk : nullptr;
+    }
+
+    FORCEINLINE FNBTAttribute* FindLiveAttribute(FNBTAttributeID ID) const {
+        uint32 LocalIndex;
+        FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex);
+        return Chunk ? Chunk->GetAttributes() + LocalIndex : nullptr;
+    }
+
+    FORCEINLINE int32* FindLiveVersion(FNBTAttributeID ID) const {
+        uint32 LocalIndex;
+        FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex);
+        return Chunk ? &Chunk->Meta.Versions[LocalIndex] : nullptr;
+    }
+
+    FORCEINLINE int32* FindLiveSubtreeVersion(FNBTAttributeID ID) const {
+        uint32 LocalIndex;
+        FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex);
+        return Chunk ? &Chunk->Meta.SubtreeVersions[LocalIndex] : nullptr;
+    }
+
+    FORCEINLINE bool IsNodeValid(FNBTAttributeID ID) const {
+        uint32 LocalIndex;
+        return FindLiveChunk(ID, LocalIndex) != nullptr;
+    }
+
+    // 父链接: 节点失效时返回无效ID, 冒泡循环据此停止
+    FORCEINLINE FNBTAttributeID GetNodeParent(FNBTAttributeID ID) const {
+        uint32 LocalIndex;
+        FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex);
+        return Chunk ? Chunk->Meta.Parents[LocalIndex] : FNBTAttributeID();
+    }
+
+    FORCEINLINE void SetNodeParent(FNBTAttributeID ID, FNBTAttributeID ParentID) const {
+        uint32 LocalIndex;
+        if (FAttributeChunk* Chunk = FindLiveChunk(ID, LocalIndex)) {
+            Chunk->Meta.Parents[LocalIndex] = ParentID;
+        }
     }
 
     // 获取属性
@@ -313,7 +521,7 @@ public:
             return nullptr;
         }
 
-        uint16 ChunkIndex = ID.Index >> CHUNK_SHIFT;
+        int32 ChunkIndex = ID.Index >> CHUNK_SHIFT;
         uint16 LocalIndex = ID.Index & CHUNK_MASK;
 
         if (ChunkIndex >= Chunks.Num()) {
@@ -332,18 +540,74 @@ public:
         return const_cast<FNBTAllocator*>(this)->GetAttribute(ID);
     }
 
+    // 整理用: 把节点搬到编号小于 ChunkLimit 的块中, 返回新ID, 旧ID随即失效
+    // 节点按位搬移, 负载不经过构造/析构; SearchHint 为调用方保存的搜索起点, 整理期间只会单调增长
+    FNBTAttributeID RelocateBelow(FNBTAttributeID ID, int32 ChunkLimit, int32& SearchHint) {
+        FNBTAttribute* Source = GetAttribute(ID);
+        if (!Source) return FNBTAttributeID();
+
+        const int32 SourceChunkIndex = ID.Index >> CHUNK_SHIFT;
+        const uint16 SourceLocalIndex = ID.Index & CHUNK_MASK;
+        const int32 Limit = FMath::Min(ChunkLimit, SourceChunkIndex);
+
+        while (SearchHint < Limit && !Chunks[SearchHint]->HasFreeSlot()) {
+            SearchHint++;
+        }
+        if (SearchHint >= Limit) return FNBTAttributeID();
+
+        const int32 TargetChunkIndex = SearchHint;
+        FAttributeChunk* TargetChunk = Chunks[TargetChunkIndex].Get();
+        FAttributeChunk* SourceChunk = Chunks[SourceChunkIndex].Get();
+
+        const uint16 TargetLocalIndex = TargetChunk->AllocateSlot().GetValue();
+        FNBTAttribute* Target = TargetChunk->GetAttributes() + TargetLocalIndex;
+        FMemory::Memcpy(Target, Source, sizeof(FNBTAttribute));
+        new(Source) FNBTAttribute(); // 负载已归新槽位所有
+        TargetChunk->Meta.Versions[TargetLocalIndex] = SourceChunk->Meta.Versions[SourceLocalIndex];
+        TargetChunk->Meta.SubtreeVersions[TargetLocalIndex] = SourceChunk->Meta.SubtreeVersions[SourceLocalIndex];
+        TargetChunk->Meta.Parents[TargetLocalIndex] = SourceChunk->Meta.Parents[SourceLocalIndex]; // 子节点的父链接由调用方在搬移后立即改写
+
+        SourceChunk->DeallocateSlot(SourceLocalIndex, ID.Generation);
+        RefreshChunkBucket(TargetChunkIndex);
+        RefreshChunkBucket(SourceChunkIndex);
+        MarkChunkChanged(TargetChunkIndex);
+        MarkChunkChanged(SourceChunkIndex);
+
+        const FNBTAttributeID::IndexType GlobalIndex = static_cast<FNBTAttributeID::IndexType>((TargetChunkIndex << CHUNK_SHIFT) | TargetLocalIndex);
+        return FNBTAttributeID(GlobalIndex, TargetChunk->Meta.Generations[TargetLocalIndex]);
+    }
+
+    // 释放尾部的空块, 至少保留一个块, 返回释放的块数
+    int32 TrimTrailingEmptyChunks() {
+        int32 Trimmed = 0;
+        while (Chunks.Num() > 1 && Chunks.Last()->GetUsedCount() == 0) {
+            SaveChunkWatermark(Chunks.Num() - 1);
+            UnlinkChunkFromBucket(Chunks.Num() - 1);
+            Chunks.Pop();
+            ChunkLinks.Pop();
+            ChunkChangeStamps.Pop();
+            Trimmed++;
+        }
+        return Trimmed;
+    }
+
+    // 容纳当前所有节点所需的最少块数
+    int32 GetMinimalChunkCount() const {
+        return FMath::Max(1, static_cast<int32>(FMath::DivideAndRoundUp(Stats.CurrentActive, CHUNK_SIZE)));
+    }
+
     // 批量操作优化
     template <typename Func>
     void ForEachAttribute(Func&& Function) {
         for (const auto& Chunk : Chunks) {
             if (Chunk->Meta.UsedCount == 0) continue;
 
-            FNBTAttribute* Attributes = reinterpret_cast<FNBTAttribute*>(Chunk->AttributeBuffer);
+            FNBTAttribute* Attributes = Chunk->GetAttributes();
             uint64 Mask = Chunk->Meta.UsedMask;
 
             while (Mask) {
                 uint32 LocalIndex = FMath::CountTrailingZeros64(Mask);
-                uint16 GlobalIndex = static_cast<uint16>((Chunk->Meta.ChunkIndex << CHUNK_SHIFT) | LocalIndex);
+                FNBTAttributeID::IndexType GlobalIndex = static_cast<FNBTAttributeID::IndexType>((Chunk->Meta.ChunkIndex << CHUNK_SHIFT) | LocalIndex);
                 FNBTAttributeID ID(GlobalIndex, Chunk->Meta.Generations[LocalIndex]);
 
                 Function(ID, Attributes[LocalIndex]);
@@ -359,7 +623,21 @@ public:
     uint32 GetCurrentActive() const { return Stats.CurrentActive; } // 当前数量
     uint32 GetPeakActive() const { return Stats.PeakActive; } // 最高使用
     uint32 GetChunkCount() const { return Chunks.Num(); } //当前块数量
-    uint32 GetFreeRemaining() const { return 65535 - GetCurrentActive(); }
+    uint32 GetFreeRemaining() const { return MAX_ACTIVE_NODES - GetCurrentActive(); }
+
+    FNBTPayloadPool& GetPayloadPool() const { return PayloadPool; }
+
+    uint64 GetChangeClock() const { return ChangeClock; }
+
+    // 块在 SinceClock 之后是否发生过影响网络差分的修改, 越界的块视为已变更
+    FORCEINLINE bool IsChunkChangedSince(int32 ChunkIndex, uint64 SinceClock) const {
+        return !ChunkChangeStamps.IsValidIndex(ChunkIndex) || ChunkChangeStamps[ChunkIndex] > SinceClock;
+    }
+
+    // 块最近一次变更时的时钟值, 相同的值说明块内容未变, 可复用基于它生成的快照
+    uint64 GetChunkChangeStamp(int32 ChunkIndex) const {
+        return ChunkChangeStamps.IsValidIndex(ChunkIndex) ? ChunkChangeStamps[ChunkIndex] : 0;
+    }
 
     const FNBTAttributeChunkMetaData* GetChunkMetadata(int32 ChunkIndex) const {
         if (Chunks.IsValidIndex(ChunkIndex)) {
@@ -369,38 +647,99 @@ public:
     }
 
     // 内存使用估算
-    SIZE_T GetMemoryUsage() const { return Chunks.Num() * sizeof(FAttributeChunk); }
+    SIZE_T GetMemoryUsage() const { return Chunks.Num() * (sizeof(FAttributeChunk) + sizeof(FNBTAttributeChunkPayload)); }
 
 private:
     // 分配新块
-    uint16 AllocateNewChunk() {
-        uint16 NewIndex = Chunks.Num();
+    uint32 AllocateNewChunk() {
+        const uint32 NewIndex = Chunks.Num();
         check(NewIndex < MAX_CHUNKS);
-        Chunks.Add(MakeUnique<FAttributeChunk>(NewIndex));
+        const FNBTChunkSlotWatermark* Watermark = ChunkWatermarks.IsValidIndex(NewIndex) ? &ChunkWatermarks[NewIndex] : nullptr;
+        Chunks.Add(FAttributeChunkPtr(FNBTChunkPool::Get().Acquire(NewIndex, &PayloadPool, Watermark)));
+        ChunkLinks.AddDefaulted();
+        ChunkChangeStamps.Add(++ChangeClock); // 同一编号的块可能被释放后重建, 新块总是晚于所有已有快照
+        LinkChunkToBucket(NewIndex);
         return NewIndex;
     }
 
-    // 根据策略选择块
-    uint16 SelectOrCreateChunkForBestAllocation() {
-        bool bHasFreeSlots = false;
-        
-        uint16 BestChunk = 0;
-        uint8 MaxUsed = 0;
-        
-        for (int i = 0; i < Chunks.Num(); ++i){
-            if (!Chunks[i]->HasFreeSlot()) continue;
-            uint8 Used = Chunks[i]->GetUsedCount();
-            if (Used > MaxUsed) {
-                MaxUsed = Used;
-                BestChunk = i;
-                bHasFreeSlots = true;
-            }
+    // 根据策略选择块: 优先填充最密的非满块, 没有非满块时才分配新块
+    uint32 SelectOrCreateChunkForBestAllocation() {
+        if (NonEmptyBucketMask == 0) {
+            return AllocateNewChunk();
         }
-        
-        if (!bHasFreeSlots) {
-            BestChunk = AllocateNewChunk();
+        const uint32 DensestBucket = static_cast<uint32>(FMath::FloorLog2_64(NonEmptyBucketMask));
+        return BucketHeads[DensestBucket];
+    }
+
+    // 析构所有节点, 竞技场模式下池内负载随Slab一起整体释放
+    void ReleaseAllNodes() {
+        const bool bArenaTeardown = PayloadPool.IsArenaEnabled();
+        for (FAttributeChunkPtr& Chunk : Chunks) {
+            Chunk->ReleaseAllSlots(bArenaTeardown);
         }
-        
-        return BestChunk;
+        PayloadPool.OnAllPayloadsReleased();
+        for (int32 ChunkIndex = 0; ChunkIndex < ChunkChangeStamps.Num(); ++ChunkIndex) {
+            MarkChunkChanged(ChunkIndex);
+        }
+    }
+
+    // 记录块内各槽位的代数与结构版本, 块随后被释放
+    void SaveChunkWatermark(int32 ChunkIndex) {
+        if (ChunkWatermarks.Num() <= ChunkIndex) {
+            ChunkWatermarks.SetNum(ChunkIndex + 1);
+        }
+        const FNBTAttributeChunkMetaData& Meta = Chunks[ChunkIndex]->Meta;
+        FNBTChunkSlotWatermark& Watermark = ChunkWatermarks[ChunkIndex];
+        FMemory::Memcpy(Watermark.Generations, Meta.Generations, sizeof(Watermark.Generations));
+        FMemory::Memcpy(Watermark.StructVersions, Meta.StructVersions, sizeof(Watermark.StructVersions));
+    }
+
+    FORCEINLINE void MarkChunkChanged(int32 ChunkIndex) {
+        ChunkChangeStamps[ChunkIndex] = ++ChangeClock;
+    }
+
+    void ResetFreeChunkIndex() {
+        ChunkLinks.Reset();
+        for (int32& Head : BucketHeads) { Head = INDEX_NONE; }
+        NonEmptyBucketMask = 0;
+    }
+
+    void LinkChunkToBucket(int32 ChunkIndex) {
+        const uint8 Used = Chunks[ChunkIndex]->GetUsedCount();
+        if (Used >= CHUNK_SIZE) return; // 满块不入桶
+
+        FChunkBucketLink& Link = ChunkLinks[ChunkIndex];
+        Link.Bucket = Used;
+        Link.Prev = INDEX_NONE;
+        Link.Next = BucketHeads[Used];
+        if (Link.Next != INDEX_NONE) {
+            ChunkLinks[Link.Next].Prev = ChunkIndex;
+        }
+        BucketHeads[Used] = ChunkIndex;
+        NonEmptyBucketMask |= (1ULL << Used);
+    }
+
+    void UnlinkChunkFromBucket(int32 ChunkIndex) {
+        FChunkBucketLink& Link = ChunkLinks[ChunkIndex];
+        if (Link.Bucket == NOT_IN_BUCKET) return;
+
+        if (Link.Prev != INDEX_NONE) {
+            ChunkLinks[Link.Prev].Next = Link.Next;
+        } else {
+            BucketHeads[Link.Bucket] = Link.Next;
+        }
+        if (Link.Next != INDEX_NONE) {
+            ChunkLinks[Link.Next].Prev = Link.Prev;
+        }
+        if (BucketHeads[Link.Bucket] == INDEX_NONE) {
+            NonEmptyBucketMask &= ~(1ULL << Link.Bucket);
+        }
+        Link = FChunkBucketLink();
+    }
+
+    // 块的占用数变化后调用, 将其移动到对应的桶
+    void RefreshChunkBucket(int32 ChunkIndex) {
+        UnlinkChunkFromBucket(ChunkIndex);
+        LinkChunkToBucket(ChunkIndex);
     }
 };
\ No newline at end of file
@@ -1,5 +1,4 @@
 ﻿#include "NBTAttribute.h"
-#include "Misc/TVariant.h"
 #include "NBTHelper.h"
 
 using namespace ArzNBT;
@@ -25,71 +24,71 @@ bool FNBTAttribute::EqualsValues(const FNBTAttribute& Other) const {
             return true;
 
         case ENBTAttributeType::Boolean:
-            return Value.Get<bool>() == Other.Value.Get<bool>();
+            return GetUnchecked<bool>() == Other.GetUnchecked<bool>();
         case ENBTAttributeType::Int8:
-            return Value.Get<int8>() == Other.Value.Get<int8>();
+            return GetUnchecked<int8>() == Other.GetUnchecked<int8>();
         case ENBTAttributeType::Int16:
-            return Value.Get<int16>() == Other.Value.Get<int16>();
+            return GetUnchecked<int16>() == Other.GetUnchecked<int16>();
         case ENBTAttributeType::Int32:
-            return Value.Get<int32>() == Other.Value.Get<int32>();
+            return GetUnchecked<int32>() == Other.GetUnchecked<int32>();
         case ENBTAttributeType::Int64:
-            return Value.Get<int64>() == Other.Value.Get<int64>();
+            return GetUnchecked<int64>() == Other.GetUnchecked<int64>();
 
         case ENBTAttributeType::Float:
-            return FMath::IsNearlyEqual(Value.Get<float>(), Other.Value.Get<float>(), 0.0001f);
+            return FMath::IsNearlyEqual(GetUnchecked<float>(), Other.GetUnchecked<float>(), 0.0001f);
         case ENBTAttributeType::Double:
-            return FMath::IsNearlyEqual(Value.Get<double>(), Other.Value.Get<double>(), 0.0001f);
+            return FMath::IsNearlyEqual(GetUnchecked<double>(), Other.GetUnchecked<double>(), 0.0001f);
 
         case ENBTAttributeType::Name:
-            return Value.Get<FName>() == Other.Value.Get<FName>();
+            return GetUnchecked<FName>() == Other.GetUnchecked<FName>();
         case ENBTAttributeType::String:
-            return Value.Get<FString>() == Other.Value.Get<FString>();
+            return GetUnchecked<FString>() == Other.GetUnchecked<FString>();
 
         case ENBTAttributeType::Color:
-            return Value.Get<FColor>() == Other.Value.Get<FColor>();
+            return GetUnchecked<FColor>() == Other.GetUnchecked<FColor>();
         case ENBTAttributeType::Guid:
-            return Value.Get<FGuid>() == Other.Value.Get<FGuid>();
+            return GetUnchecked<FGuid>() == Other.GetUnchecked<FGuid>();
         case ENBTAttributeType::SoftClassPath:
-            return Value.Get<FSoftClassPath>() == Other.Value.Get<FSoftClassPath>();
+            return GetUnchecked<FSoftClassPath>() == Other.GetUnchecked<FSoftClassPath>();
         case ENBTAttributeType::SoftObjectPath:
-            return Value.Get<FSoftObjectPath>() == Other.Value.Get<FSoftObjectPath>();
+            return GetUnchecked<FSoftObjectPath>() == Other.GetUnchecked<FSoftObjectPath>();
         case ENBTAttributeType::DateTime:
-            return Value.Get<FDateTime>() == Other.Value.Get<FDateTime>();
+            return GetUnchecked<FDateTime>() == Other.GetUnchecked<FDateTime>();
 
         case ENBTAttributeType::Rotator:
-            return Value.Get<FRotator>().Equals(Other.Value.Get<FRotator>());
+            return GetUnchecked<FRotator>().Equals(Other.GetUnchecked<FRotator>());
         case ENBTAttributeType::Vector2D:
-            return Value.Get<FVector2D>().Equals(Other.Value.Get<FVector2D>());
+            return GetUnchecked<FVector2D>().Equals(Other.GetUnchecked<FVector2D>());
         case ENBTAttributeType::Vector:
-            return Value.Get<FVector>().Equals(Other.Value.Get<FVector>());
+            return GetUnchecked<FVector>().Equals(Other.GetUnchecked<FVector>());
 
         case ENBTAttributeType::IntVector2:
-            return Value.Get<FIntVector2>() == Other.Value.Get<FIntVector2>();
+            return GetUnchecked<FIntVector2>() == Other.GetUnchecked<FIntVector2>();
         case ENBTAttributeType::IntVector:
-            return Value.Get<FIntVector>() == Other.Value.Get<FIntVector>();
+            return GetUnchecked<FIntVector>() == Other.GetUnchecked<FIntVector>();
 
         case ENBTAttributeType::Int64Vector2:
-            return Value.Get<FInt64Vector2>() == Other.Value.Get<FInt64Vector2>();
+            return GetUnchecked<FInt64Vector2>() == Other.GetUnchecked<FInt64Vector2>();
         case ENBTAttributeType::Int64Vector:
-            return Value.Get<FInt64Vector>() == Other.Value.Get<FInt64Vector>();
+            return GetUnchecked<FInt64Vector>() == Other.GetUnchecked<FInt64Vector>();
 
         case ENBTAttributeType::ArrayInt8:
-            return Value.Get<TArray<int8>>() == Other.Value.Get<TArray<int8>>();
+            return GetUnchecked<TArray<int8>>() == Other.GetUnchecked<TArray<int8>>();
         case ENBTAttributeType::ArrayInt16:
-            return Value.Get<TArray<int16>>() == Other.Value.Get<TArray<int16>>();
+            return GetUnchecked<TArray<int16>>() == Other.GetUnchecked<TArray<int16>>();
         case ENBTAttributeType::ArrayInt32:
-            return Value.Get<TArray<int32>>() == Other.Value.Get<TArray<int32>>();
+            return GetUnchecked<TArray<int32>>() == Other.GetUnchecked<TArray<int32>>();
         case ENBTAttributeType::ArrayInt64:
-            return Value.Get<TArray<int64>>() == Other.Value.Get<TArray<int64>>();
+            return GetUnchecked<TArray<int64>>() == Other.GetUnchecked<TArray<int64>>();
 
         case ENBTAttributeType::ArrayFloat32: {
-            const auto& ArrayA = Value.Get<TArray<float>>();
-            const auto& ArrayB = Other.Value.Get<TArray<float>>();
+            const auto& ArrayA = GetUnchecked<TArray<float>>();
+            const auto& ArrayB = Other.GetUnchecked<TArray<float>>();
             return HelperCompareFloatArray<float>(ArrayA, ArrayB);
         }
         case ENBTAttributeType::ArrayDouble: {
-            const auto& ArrayA = Value.Get<TArray<double>>();
-            const auto& ArrayB = Other.Value.Get<TArray<double>>();
+            const auto& ArrayA = GetUnchecked<TArray<double>>();
+            const auto& ArrayB = Other.GetUnchecked<TArray<double>>();
             return HelperCompareFloatArray<double>(ArrayA, ArrayB);
         }
         case ENBTAttributeType::Map:
@@ -107,77 +106,77 @@ FString FNBTAttribute::ToString() const {
         case ENBTAttributeType::Empty:
             return "$Empty$";
         case ENBTAttributeType::Boolean:
-            return Value.Get<bool>() ? "True" : "False";
+            return GetUnchecked<bool>() ? "True" : "False";
         case ENBTAttributeType::Int8:
-            return FString::FromInt(Value.Get<int8>()) + " (Int8)";
+            return FString::FromInt(GetUnchecked<int8>()) + " (Int8)";
         case ENBTAttributeType::Int16:
-            return FString::FromInt(Value.Get<int16>()) + " (Int16)";
+            return FString::FromInt(GetUnchecked<int16>()) + " (Int16)";
         case ENBTAttributeType::Int32:
-            return FString::FromInt(Value.Get<int32>()) + " (Int32)";
+            return FString::FromInt(GetUnchecked<int32>()) + " (Int32)";
         case ENBTAttributeType::Int64:
-            return FString::Printf(TEXT("%lld (Int64)"), Value.Get<int64>());
+            return FString::Printf(TEXT("%lld (Int64)"), GetUnchecked<int64>());
         case ENBTAttributeType::Float:
-            return FString::SanitizeFloat(Value.Get<float>()) + " (Float)";
+            return FString::SanitizeFloat(GetUnchecked<float>()) + " (Float)";
         case ENBTAttributeType::Double:
-            return FString::SanitizeFloat(Value.Get<double>()) + " (Double)";
+            return FString::SanitizeFloat(GetUnchecked<double>()) + " (Double)";
         case ENBTAttributeType::Name:
-            return "\"" + Value.Get<FName>().ToString() + "\" (Name)";
+            return "\"" + GetUnchecked<FName>().ToString() + "\" (Name)";
         case ENBTAttributeType::String:
-            return "\"" + Value.Get<FString>() + "\" (String)";
+            return "\"" + GetUnchecked<FString>() + "\" (String)";
 
         case ENBTAttributeType::Color:
-            return FString::Printf(TEXT("%s (Color)"), *Value.Get<FColor>().ToString());
+            return FString::Printf(TEXT("%s (Color)"), *GetUnchecked<FColor>().ToString());
         case ENBTAttributeType::Guid:
-            return FString::Printf(TEXT("%s (Guid)"), *Value.Get<FGuid>().ToString());
+            return FString::Printf(TEXT("%s (Guid)"), *GetUnchecked<FGuid>().ToString());
         case ENBTAttributeType::SoftClassPath:
-            return FString::Printf(TEXT("%s (SoftClassPath)"), *Value.Get<FSoftClassPath>().ToString());
+            return FString::Printf(TEXT("%s (SoftClassPath)"), *GetUnchecked<FSoftClassPath>().ToString());
         case ENBTAttributeType::SoftObjectPath:
-            return FString::Printf(TEXT("%s (SoftObjectPath)"), *Value.Get<FSoftObjectPath>().ToString());
+            return FString::Printf(TEXT("%s (SoftObjectPath)"), *GetUnchecked<FSoftObjectPath>().ToString());
         case ENBTAttributeType::DateTime:
-            return FString::Printf(TEXT("%s (DateTime)"), *Value.Get<FDateTime>().ToString());
+            return FString::Printf(TEXT("%s (DateTime)"), *GetUnchecked<FDateTime>().ToString());
 
         case ENBTAttributeType::Rotator:
-            return "\"" + Value.Get<FRotator>().ToString() + "\" (Rotator)";
+            return "\"" + GetUnchecked<FRotator>().ToString() + "\" (Rotator)";
         case ENBTAttributeType::Vector2D:
-            return Value.Get<FVector2D>().ToString() + " (Vector2D)";
+            return GetUnchecked<FVector2D>().ToString() + " (Vector2D)";
         case ENBTAttributeType::Vector:
-            return Value.Get<FVector>().ToString() + " (Vector)";
+            return GetUnchecked<FVector>().ToString() + " (Vector)";
         case ENBTAttributeType::IntVector2:
-            return Value.Get<FIntVector2>().ToString() + " (IntVector2)";
+            return GetUnchecked<FIntVector2>().ToString() + " (IntVector2)";
         case ENBTAttributeType::IntVector:
-            return Value.Get<FIntVector>().ToString() + " (IntVector)";
+            return GetUnchecked<FIntVector>().ToString() + " (IntVector)";
         case ENBTAttributeType::Int64Vector2:
-            return Value.Get<FInt64Vector2>().ToString() + " (Int64Vector2)";
+            return GetUnchecked<FInt64Vector2>().ToString() + " (Int64Vector2)";
         case ENBTAttributeType::Int64Vector:
-            return Value.Get<FInt64Vector>().ToString() + " (Int64Vector)";
+            return GetUnchecked<FInt64Vector>().ToString() + " (Int64Vector)";
         case ENBTAttributeType::ArrayInt8:
-            return FString::Printf(TEXT("[%s] (ArrayInt8)"), *FString::JoinBy(Value.Get<TArray<int8>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayInt8)"), *FString::JoinBy(GetUnchecked<TArray<int8>>(), TEXT(", "),
                                                                              [](int8 InValue) {
                                                                                  return FString::FromInt(InValue);
                                                                              }));
         case ENBTAttributeType::ArrayInt16:
-            return FString::Printf(TEXT("[%s] (ArrayInt16)"), *FString::JoinBy(Value.Get<TArray<int16>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayInt16)"), *FString::JoinBy(GetUnchecked<TArray<int16>>(), TEXT(", "),
                                                                               [](int16 InValue) {
                                                                                   return FString::FromInt(InValue);
                                                                               }));
         case ENBTAttributeType::ArrayInt32:
-            return FString::Printf(TEXT("[%s] (ArrayInt32)"), *FString::JoinBy(Value.Get<TArray<int32>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayInt32)"), *FString::JoinBy(GetUnchecked<TArray<int32>>(), TEXT(", "),
                                                                               [](int32 InValue) {
                                                                                   return FString::FromInt(InValue);
                                                                               }));
         case ENBTAttributeType::ArrayInt64:
-            return FString::Printf(TEXT("[%s] (ArrayInt64)"), *FString::JoinBy(Value.Get<TArray<int64>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayInt64)"), *FString::JoinBy(GetUnchecked<TArray<int64>>(), TEXT(", "),
                                                                               [](int64 InValue) {
                                                                                   return FString::Printf(
                                                                                       TEXT("%lld"), InValue);
                                                                               }));
         case ENBTAttributeType::ArrayFloat32:
-            return FString::Printf(TEXT("[%s] (ArrayFloat32)"), *FString::JoinBy(Value.Get<TArray<float>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayFloat32)"), *FString::JoinBy(GetUnchecked<TArray<float>>(), TEXT(", "),
                                                                                 [](float InValue) {
                                                                                     return FString::SanitizeFloat(InValue);
                                                                                 }));
         case ENBTAttributeType::ArrayDouble:
-            return FString::Printf(TEXT("[%s] (ArrayDouble)"), *FString::JoinBy(Value.Get<TArray<double>>(), TEXT(", "),
+            return FString::Printf(TEXT("[%s] (ArrayDouble)"), *FString::JoinBy(GetUnchecked<TArray<double>>(), TEXT(", "),
                                                                                  [](double InValue) {
                                                                                      return FString::SanitizeFloat(InValue);
                                                                                  }));
@@ -190,116 +189,85 @@ FString FNBTAttribute::ToString() const {
     }
 }
 
-void FNBTAttribute::SerializeNBTData(FArchive& Ar, bool NetWorkMode) {
+void FNBTAttribute::Release(FNBTPayloadPool& Pool) {
+    switch (Type) {
+#define ARZ_NBT_RELEASE_CASE(EnumName, CppType) \
+        case ENBTAttributeType::EnumName: DestroyPayload<CppType>(Pool); break;
+        ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_RELEASE_CASE)
+#undef ARZ_NBT_RELEASE_CASE
+        default: break;
+    }
+    Type = ENBTAttributeType::Empty;
+}
+
+void FNBTAttribute::ReleaseForArenaTeardown(FNBTPayloadPool& Pool) {
+    switch (Type) {
+#define ARZ_NBT_ARENA_RELEASE_CASE(EnumName, CppType) \
+        case ENBTAttributeType::EnumName: DestroyPayload<CppType, true>(Pool); break;
+        ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_ARENA_RELEASE_CASE)
+#undef ARZ_NBT_ARENA_RELEASE_CASE
+        default: break;
+    }
+    Type = ENBTAttributeType::Empty;
+}
+
+bool FNBTAttribute::EmplaceDefault(FNBTPayloadPool& Pool, ENBTAttributeType InType) {
+    switch (InType) {
+        case ENBTAttributeType::Empty:
+            Release(Pool);
+            return true;
+#define ARZ_NBT_EMPLACE_DEFAULT_CASE(EnumName, CppType) \
+        case ENBTAttributeType::EnumName: Emplace<CppType>(Pool); return true;
+        ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_EMPLACE_DEFAULT_CASE)
+#undef ARZ_NBT_EMPLACE_DEFAULT_CASE
+        default:
+            Release(Pool);
+            return false;
+    }
+}
+
+void FNBTAttribute::SerializeNBTData(FArchive& Ar, bool NetWorkMode, FNBTPayloadPool& Pool) {
     uint8 TypeIndex;
     if (Ar.IsSaving()) {
-        TypeIndex = static_cast<uint8>(Value.GetIndex());
+        TypeIndex = static_cast<uint8>(Type);
     }
     Ar << TypeIndex;
 
     if (Ar.IsLoading()) {
-        // 根据从存档中读取的类型，设置 Variant 的当前活动类型
-        // 使用枚举代替魔法数字，更安全易读
-        switch (static_cast<ENBTAttributeType>(TypeIndex)) {
-            case ENBTAttributeType::Empty: Value.Set<FEmptyVariantState>({});
-                break;
-            case ENBTAttributeType::Boolean: Value.Set<bool>({});
-                break;
-            case ENBTAttributeType::Int8: Value.Set<int8>({});
-                break;
-            case ENBTAttributeType::Int16: Value.Set<int16>({});
-                break;
-            case ENBTAttributeType::Int32: Value.Set<int32>({});
-                break;
-            case ENBTAttributeType::Int64: Value.Set<int64>({});
-                break;
-            case ENBTAttributeType::Float: Value.Set<float>({});
-                break;
-            case ENBTAttributeType::Double: Value.Set<double>({});
-                break;
-            case ENBTAttributeType::Name: Value.Set<FName>({});
-                break;
-            case ENBTAttributeType::String: Value.Set<FString>({});
-                break;
-
-            case ENBTAttributeType::Color:
-                Value.Set<FColor>({});
-                break;
-            case ENBTAttributeType::Guid:
-                Value.Set<FGuid>({});
-                break;
-            case ENBTAttributeType::SoftClassPath:
-                Value.Set<FSoftClassPath>({});
-                break;
-            case ENBTAttributeType::SoftObjectPath:
-                Value.Set<FSoftObjectPath>({});
-                break;
-            case ENBTAttributeType::DateTime:
-                Value.Set<FDateTime>({});
-                break;
-            case ENBTAttributeType::Rotator: Value.Set<FRotator>({});
-                break;
-            case ENBTAttributeType::Vector2D: Value.Set<FVector2D>({});
-                break;
-            case ENBTAttributeType::Vector: Value.Set<FVector>({});
-                break;
-            case ENBTAttributeType::IntVector2: Value.Set<FIntVector2>({});
-                break;
-            case ENBTAttributeType::IntVector: Value.Set<FIntVector>({});
-                break;
-            case ENBTAttributeType::Int64Vector2: Value.Set<FInt64Vector2>({});
-                break;
-            case ENBTAttributeType::Int64Vector: Value.Set<FInt64Vector>({});
-                break;
-            case ENBTAttributeType::ArrayInt8: Value.Set<TArray<int8>>({});
-                break;
-            case ENBTAttributeType::ArrayInt16: Value.Set<TArray<int16>>({});
-                break;
-            case ENBTAttributeType::ArrayInt32: Value.Set<TArray<int32>>({});
-                break;
-            case ENBTAttributeType::ArrayInt64: Value.Set<TArray<int64>>({});
-                break;
-            case ENBTAttributeType::ArrayFloat32: Value.Set<TArray<float>>({});
-                break;
-            case ENBTAttributeType::ArrayDouble: Value.Set<TArray<double>>({});
-                break;
-            case ENBTAttributeType::Map: Value.Set<FNBTMapData>(FNBTMapData{});
-                break;
-            case ENBTAttributeType::List: Value.Set<FNBTListData>(FNBTListData{});
-                break;
-            default:
-                Value.Set<FEmptyVariantState>({});
-                UE_LOG(NBTSystem, Warning, TEXT("Unknown NBT attribute type index %d encountered during serialization."),
-                       TypeIndex);
-                break;
+        // 根据从存档中读取的类型，构造对应类型的默认值
+        if (!EmplaceDefault(Pool, static_cast<ENBTAttributeType>(TypeIndex))) {
+            UE_LOG(NBTSystem, Warning, TEXT("Unknown NBT attribute type index %d encountered during serialization."),
+                   TypeIndex);
         }
     }
     
-    Visit([&Ar, NetWorkMode]<typename T0>(T0& ActiveValue) {
+    VisitValue([&Ar, NetWorkMode]<typename T0>(T0& ActiveValue) {
         using T = std::decay_t<T0>;
-        if constexpr (!std::is_same_v<T, FEmptyVariantState>) {
-            if constexpr (std::is_same_v<T, FVector2D> || std::is_same_v<T, FVector> || std::is_same_v<T, FRotator>) {
-                bool bSuccess = true;
-                ActiveValue.NetSerialize(Ar, nullptr, bSuccess);
-            } else if constexpr (std::is_same_v<T, FNBTMapData> || std::is_same_v<T, FNBTListData>) {
-                ActiveValue.SerializeNBTData(Ar, NetWorkMode);
-            } else if constexpr (is_strict_integer_v<T>) {
-                SerializeZigZag(Ar, ActiveValue);
-            }else {
-                Ar << ActiveValue;
-            }
+        if constexpr (std::is_same_v<T, FVector2D> || std::is_same_v<T, FVector> || std::is_same_v<T, FRotator>) {
+            bool bSuccess = true;
+            ActiveValue.NetSerialize(Ar, nullptr, bSuccess);
+        } else if constexpr (std::is_same_v<T, FNBTMapData> || std::is_same_v<T, FNBTListData>) {
+            ActiveValue.SerializeNBTData(Ar, NetWorkMode);
+        } else if constexpr (is_strict_integer_v<T>) {
+            SerializeZigZag(Ar, ActiveValue);
+        }else {
+            Ar << ActiveValue;
         }
-    }, Value);
+    });
 }
 
 void FNBTMapData::SerializeNBTData(FArchive& Ar, bool NetWorkMode) {
+#if ARZ_NBT_WIDE_ID
+    uint32 NumAttributes = Children.Num(); // 宽ID模式下单个Map可能超过65535个子项
+#else
     uint16 NumAttributes = Children.Num();
+#endif
     Ar << NumAttributes;
 
     if (Ar.IsLoading()) {
         Children.Reset();
         Children.Reserve(NumAttributes);
-        for (int16 i = 0; i < NumAttributes; ++i) {
+        for (uint32 i = 0; i < NumAttributes; ++i) {
             FName AttributeName;
             FNBTAttributeID AttributeID;
             Ar << AttributeName;
@@ -3,48 +3,231 @@
 #include "CoreMinimal.h"
 #include "NBTCommon.h"
 #include "NBTAttributeID.h"
+#include "NBTPayloadPool.h"
 #include "UObject/Object.h"
 
 struct FNBTAttribute;
 struct FNBTMapData;
 struct FNBTListData;
 
+// Map子项表: 小Map使用按FName索引排序的连续数组, 线性查找; 超过阈值后额外建立哈希索引
+// 接口与 TMap<FName, FNBTAttributeID> 的常用部分保持一致, 遍历元素同样为 TPair(Key, Value)
+class FNBTMapChildren {
+public:
+    using ElementType = TPair<FName, FNBTAttributeID>;
+
+    static constexpr int32 FLAT_MAX_NUM = 8;     // 超过该数量时建立哈希索引
+    static constexpr int32 FLAT_RESTORE_NUM = 4; // 回落到该数量时释放哈希索引, 避免在阈值附近反复切换
+
+private:
+    // 平坦模式下按 FName::CompareIndexes 排序, 哈希模式下无序
+    TArray<ElementType, TInlineAllocator<4>> Entries;
+
+    // 键 -> Entries 下标, 仅哈希模式下存在
+    TUniquePtr<TMap<FName, int32>> Index;
+
+public:
+    FNBTMapChildren() = default;
+
+    FNBTMapChildren(const FNBTMapChildren& Other) : Entries(Other.Entries) {
+        if (Other.Index) RebuildIndex();
+    }
+
+    FNBTMapChildren& operator=(const FNBTMapChildren& Other) {
+        if (this != &Other) {
+            Entries = Other.Entries;
+            Index.Reset();
+            if (Other.Index) RebuildIndex();
+        }
+        return *this;
+    }
+
+    FNBTMapChildren(FNBTMapChildren&&) = default;
+    FNBTMapChildren& operator=(FNBTMapChildren&&) = default;
+
+    int32 Num() const { return Entries.Num(); }
+
+    bool IsEmpty() const { return Entries.IsEmpty(); }
+
+    bool IsHashed() const { return Index.IsValid(); }
+
+    FNBTAttributeID* Find(FName Key) {
+        const int32 Slot = FindSlot(Key);
+        return Slot != INDEX_NONE ? &Entries[Slot].Value : nullptr;
+    }
+
+    const FNBTAttributeID* Find(FName Key) const {
+        return const_cast<FNBTMapChildren*>(this)->Find(Key);
+    }
+
+    bool Contains(FName Key) const { return FindSlot(Key) != INDEX_NONE; }
+
+    // 与TMap一致: 已存在则覆盖
+    FNBTAttributeID& Emplace(FName Key, FNBTAttributeID Value) {
+        if (Index) {
+            if (const int32* Slot = Index->Find(Key)) {
+                Entries[*Slot].Value = Value;
+                return Entries[*Slot].Value;
+            }
+            const int32 NewSlot = Entries.Emplace(Key, Value);
+            Index->Add(Key, NewSlot);
+            return Entries[NewSlot].Value;
+        }
+
+        int32 InsertAt = 0;
+        for (; InsertAt < Entries.Num(); ++InsertAt) {
+            const int32 Cmp = Entries[InsertAt].Key.CompareIndexes(Key);
+            if (Cmp == 0) {
+                Entries[InsertAt].Value = Value;
+                return Entries[InsertAt].Value;
+            }
+            if (Cmp > 0) break;
+        }
+        Entries.EmplaceAt(InsertAt, Key, Value);
+        if (Entries.Num() > FLAT_MAX_NUM) {
+            RebuildIndex();
+        }
+        return Entries[InsertAt].Value;
+    }
+
+    FNBTAttributeID& Add(FName Key, FNBTAttributeID Value) { return Emplace(Key, Value); }
+
+    int32 Remove(FName Key) {
+        const int32 Slot = FindSlot(Key);
+        if (Slot == INDEX_NONE) return 0;
+
+        if (!Index) {
+            Entries.RemoveAt(Slot);
+            return 1;
+        }
+
+        Index->Remove(Key);
+        const int32 LastSlot = Entries.Num() - 1;
+        if (Slot != LastSlot) {
+            Index->FindChecked(Entries[LastSlot].Key) = Slot;
+        }
+        Entries.RemoveAtSwap(Slot);
+
+        if (Entries.Num() <= FLAT_RESTORE_NUM) {
+            Index.Reset();
+            Entries.Sort([](const ElementType& A, const ElementType& B) { return A.Key.CompareIndexes(B.Key) < 0; });
+        }
+        return 1;
+    }
+
+    void Reserve(int32 Number) { Entries.Reserve(Number); }
+
+    void Reset() {
+        Entries.Reset();
+        Index.Reset();
+    }
+
+    void Empty() {
+        Entries.Empty();
+        Index.Reset();
+    }
+
+    ElementType* begin() { return Entries.GetData(); }
+    ElementType* end() { return Entries.GetData() + Entries.Num(); }
+    const ElementType* begin() const { return Entries.GetData(); }
+    const ElementType* end() const { return Entries.GetData() + Entries.Num(); }
+
+private:
+    int32 FindSlot(FName Key) const {
+        if (Index) {
+            const int32* Slot = Index->Find(Key);
+            return Slot ? *Slot : INDEX_NONE;
+        }
+        for (int32 i = 0; i < Entries.Num(); ++i) {
+            const int32 Cmp = Entries[i].Key.CompareIndexes(Key);
+            if (Cmp == 0) return i;
+            if (Cmp > 0) break;
+        }
+        return INDEX_NONE;
+    }
+
+    void RebuildIndex() {
+        Index = MakeUnique<TMap<FName, int32>>();
+        Index->Reserve(Entries.Num());
+        for (int32 i = 0; i < Entries.Num(); ++i) {
+            Index->Add(Entries[i].Key, i);
+        }
+    }
+};
+
 struct FNBTMapData {
-    TMap<FName, FNBTAttributeID> Children;
+    FNBTMapChildren Children;
     void SerializeNBTData(FArchive& Ar, bool NetWorkMode);
 };
 
+// List子项的内联容量: 窄ID模式下 FNBTListData 恰好占用负载池的一个32字节块, 1~4个元素的List不再单独分配堆内存
+#define ARZ_NBT_LIST_INLINE_CAPACITY 4
+
 struct FNBTListData {
-    TArray<FNBTAttributeID> Children;
+    TArray<FNBTAttributeID, TInlineAllocator<ARZ_NBT_LIST_INLINE_CAPACITY>> Children;
     
     void SerializeNBTData(FArchive& Ar, bool NetWorkMode) {
         Ar << Children;
     }
 };
 
-struct FNBTAttribute {
-    using AttributeType = TVariant<
-        FEmptyVariantState,
-        bool,
-        int8, int16, int32, int64,
-        float, double,
-        FName,
-        FString,
-        FColor,
-        FGuid,
-        FSoftClassPath,
-        FSoftObjectPath,
-        FDateTime,
-        FRotator,
-        FVector2D, FVector,
-        FIntVector2, FIntVector,
-        FInt64Vector2, FInt64Vector,
-        TArray<int8>, TArray<int16>, TArray<int32>, TArray<int64>,
-        TArray<float>, TArray<double>,
-        FNBTMapData,
-        FNBTListData
-    >;
+// 节点内联负载大小, 放不下的类型存放在容器的负载侧池中, 内联区只保存指针
+#define ARZ_NBT_INLINE_PAYLOAD_SIZE 16
+
+// 属性类型表: (ENBTAttributeType, C++类型), 顺序与 ENBTAttributeType 一致
+#define ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(X) \
+    X(Boolean, bool) \
+    X(Int8, int8) \
+    X(Int16, int16) \
+    X(Int32, int32) \
+    X(Int64, int64) \
+    X(Float, float) \
+    X(Double, double) \
+    X(Name, FName) \
+    X(String, FString) \
+    X(Color, FColor) \
+    X(Guid, FGuid) \
+    X(SoftClassPath, FSoftClassPath) \
+    X(SoftObjectPath, FSoftObjectPath) \
+    X(DateTime, FDateTime) \
+    X(Rotator, FRotator) \
+    X(Vector2D, FVector2D) \
+    X(Vector, FVector) \
+    X(IntVector2, FIntVector2) \
+    X(IntVector, FIntVector) \
+    X(Int64Vector2, FInt64Vector2) \
+    X(Int64Vector, FInt64Vector) \
+    X(ArrayInt8, TArray<int8>) \
+    X(ArrayInt16, TArray<int16>) \
+    X(ArrayInt32, TArray<int32>) \
+    X(ArrayInt64, TArray<int64>) \
+    X(ArrayFloat32, TArray<float>) \
+    X(ArrayDouble, TArray<double>) \
+    X(Map, FNBTMapData) \
+    X(List, FNBTListData)
+
+template <typename T>
+struct TNBTAttributeTypeTraits {
+    static constexpr bool bSupported = false;
+};
+
+#define ARZ_NBT_DEFINE_ATTRIBUTE_TYPE_TRAITS(EnumName, CppType) \
+    template <> \
+    struct TNBTAttributeTypeTraits<CppType> { \
+        static constexpr bool bSupported = true; \
+        static constexpr ENBTAttributeType Type = ENBTAttributeType::EnumName; \
+        static constexpr bool bInline = sizeof(CppType) <= ARZ_NBT_INLINE_PAYLOAD_SIZE && alignof(CppType) <= alignof(uint64); \
+        static constexpr bool bTrivialRelease = bInline && std::is_trivially_destructible_v<CppType>; \
+    };
+
+ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_DEFINE_ATTRIBUTE_TYPE_TRAITS)
 
+#undef ARZ_NBT_DEFINE_ATTRIBUTE_TYPE_TRAITS
+
+// 紧凑节点: 1字节类型标签 + 16字节内联负载
+// 标量/小向量/名字/字符串头/数组头直接存放在内联区, 其余负载由 FNBTPayloadPool 分配, 内联区只存指针
+// 节点不持有负载池, 所有可能分配或释放负载的操作都需要传入所属容器的负载池
+struct FNBTAttribute {
 private:
     friend struct FNBTContainer;
 
@@ -54,9 +237,22 @@ private:
 
     friend struct FNBTDataAccessor;
 
-    AttributeType Value;
+    friend class FNBTFieldDelta;
+
+    template <typename T>
+    friend class TNBTSchemaField;
+
+#if WITH_DEV_AUTOMATION_TESTS
+    friend struct FNBTTestAccess; // 仅测试/基准使用, 见 Tests/NBTTestAccess.h
+#endif
+
+    ENBTAttributeType Type;
 
-    FNBTAttribute() { Reset(); };
+    alignas(uint64) uint8 Storage[ARZ_NBT_INLINE_PAYLOAD_SIZE];
+
+    FNBTAttribute() : Type(ENBTAttributeType::Empty) {}
+
+    // 不会释放负载, 销毁前必须先调用 Release
     ~FNBTAttribute() = default;
 
     FNBTAttribute(const FNBTAttribute&) = delete;
@@ -67,16 +263,95 @@ private:
 
     FNBTAttribute& operator=(FNBTAttribute&&) = delete;
 
-    void Reset() { Value.Set<FEmptyVariantState>({}); }
+    template <typename T>
+    FORCEINLINE T* GetPtrUnchecked() const {
+        static_assert(TNBTAttributeTypeTraits<T>::bSupported, "Unsupported NBT attribute type");
+        if constexpr (TNBTAttributeTypeTraits<T>::bInline) {
+            return reinterpret_cast<T*>(const_cast<uint8*>(Storage));
+        } else {
+            return *reinterpret_cast<T* const*>(Storage);
+        }
+    }
+
+    template <typename T>
+    FORCEINLINE T* TryGetPtr() const {
+        return IsType<T>() ? GetPtrUnchecked<T>() : nullptr;
+    }
 
-    ENBTAttributeType GetType() const { return static_cast<ENBTAttributeType>(Value.GetIndex()); }
+    template <typename T>
+    FORCEINLINE const T& GetUnchecked() const { return *GetPtrUnchecked<T>(); }
+
+    // 释放旧负载并就地构造新负载
+    template <typename T, typename... ArgTypes>
+    T& Emplace(FNBTPayloadPool& Pool, ArgTypes&&... Args) {
+        static_assert(TNBTAttributeTypeTraits<T>::bSupported, "Unsupported NBT attribute type");
+        Release(Pool);
+        T* Ptr;
+        if constexpr (TNBTAttributeTypeTraits<T>::bInline) {
+            Ptr = new(Storage) T(Forward<ArgTypes>(Args)...);
+        } else {
+            static_assert(alignof(T) <= FNBTPayloadPool::BLOCK_ALIGNMENT, "Payload alignment exceeds pool alignment");
+            Ptr = new(Pool.Allocate(sizeof(T))) T(Forward<ArgTypes>(Args)...);
+            *reinterpret_cast<T**>(Storage) = Ptr;
+        }
+        Type = TNBTAttributeTypeTraits<T>::Type;
+        return *Ptr;
+    }
+
+    // bArenaTeardown: 竞技场即将整体释放, 池内尺寸的外置块不再逐个归还
+    template <typename T, bool bArenaTeardown = false>
+    void DestroyPayload(FNBTPayloadPool& Pool) {
+        T* Ptr = GetPtrUnchecked<T>();
+        DestructItem(Ptr);
+        if constexpr (!TNBTAttributeTypeTraits<T>::bInline) {
+            if (!bArenaTeardown || !FNBTPayloadPool::IsPooledSize(sizeof(T))) {
+                Pool.Free(Ptr, sizeof(T));
+            }
+        }
+    }
+
+    // 以当前类型调用 Visitor(T&), Empty 时不调用
+    template <typename Func>
+    void VisitValue(Func&& Visitor) const {
+        switch (Type) {
+#define ARZ_NBT_VISIT_CASE(EnumName, CppType) \
+            case ENBTAttributeType::EnumName: Visitor(*GetPtrUnchecked<CppType>()); break;
+            ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_VISIT_CASE)
+#undef ARZ_NBT_VISIT_CASE
+            default: break;
+        }
+    }
+
+    // 释放负载, 变为Empty
+    void Release(FNBTPayloadPool& Pool);
+
+    // 竞技场整体释放前调用: 只析构负载, 不归还池内的块
+    void ReleaseForArenaTeardown(FNBTPayloadPool& Pool);
+
+    // 负载是否无需析构也不占用外置块, 批量销毁时可直接跳过
+    FORCEINLINE bool IsTriviallyReleasable() const {
+        switch (Type) {
+#define ARZ_NBT_TRIVIAL_RELEASE_CASE(EnumName, CppType) \
+            case ENBTAttributeType::EnumName: return TNBTAttributeTypeTraits<CppType>::bTrivialRelease;
+            ARZ_NBT_FOREACH_ATTRIBUTE_TYPE(ARZ_NBT_TRIVIAL_RELEASE_CASE)
+#undef ARZ_NBT_TRIVIAL_RELEASE_CASE
+            default: return true;
+        }
+    }
+
+    // 按类型构造默认值, 反序列化使用
+    bool EmplaceDefault(FNBTPayloadPool& Pool, ENBTAttributeType InType);
+
+    void Reset(FNBTPayloadPool& Pool) { Release(Pool); }
+
+    ENBTAttributeType GetType() const { return Type; }
 
     FString GetTypeString() const;
 
     bool IsEmpty() const { return GetType() == ENBTAttributeType::Empty; }
 
     template <typename T>
-    bool IsType() const { return Value.IsType<T>(); }
+    bool IsType() const { return Type == TNBTAttributeTypeTraits<T>::Type; }
 
     bool IsCompoundType() const { return GetType() == ENBTAttributeType::Map || GetType() == ENBTAttributeType::List; }
 
@@ -84,19 +359,19 @@ private:
 
     template <typename T>
     TOptional<T> GetBaseType() const {
-        const T* p = Value.TryGet<T>();
+        const T* p = TryGetPtr<T>();
         return p ? TOptional<T>(*p) : TOptional<T>();
     }
 
     template <typename T>
     TArray<T>* GetArrayType() {
-        auto Ptr = Value.TryGet<TArray<T>>();
+        auto Ptr = TryGetPtr<TArray<T>>();
         return Ptr;
     }
 
     template <typename T>
     ENBTAttributeOpResult TrySetBaseType(T InValue) {
-        if (T* Ptr = Value.TryGet<T>()) {
+        if (T* Ptr = TryGetPtr<T>()) {
             if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
                 if (FMath::IsNearlyEqual(*Ptr, InValue, 0.0001f)) {
                     return ENBTAttributeOpResult::SameAndNotChange;
@@ -115,7 +390,7 @@ private:
 
     template<typename T>
     ENBTAttributeOpResult TrySetBaseTypeRef(const T& InValue) {
-        if (T* Ptr = Value.TryGet<T>(); Ptr) {
+        if (T* Ptr = TryGetPtr<T>(); Ptr) {
             if (InValue == *Ptr) {
                 return ENBTAttributeOpResult::SameAndNotChange;
             }
@@ -128,7 +403,7 @@ private:
 
     template <typename T>
     ENBTAttributeOpResult TrySetArrayType(const TArray<T>& InValue) {
-        if (TArray<T>* Ptr = Value.TryGet<TArray<T>>(); Ptr) {
+        if (TArray<T>* Ptr = TryGetPtr<TArray<T>>(); Ptr) {
             if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
                 if (HelperCompareFloatArray(*Ptr, InValue)) return ENBTAttributeOpResult::SameAndNotChange;
             } else {
@@ -141,8 +416,8 @@ private:
     }
 
     template <typename T>
-    ENBTAttributeOpResult OverriderToBaseType(T InValue) {
-        if (T* Ptr = Value.TryGet<T>()) {
+    ENBTAttributeOpResult OverriderToBaseType(FNBTPayloadPool& Pool, T InValue) {
+        if (T* Ptr = TryGetPtr<T>()) {
             if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
                 if (FMath::IsNearlyEqual(*Ptr, InValue, 0.0001f)) {
                     return ENBTAttributeOpResult::SameAndNotChange;
@@ -154,79 +429,86 @@ private:
             }
             
         }
-        Value.Set<T>(InValue);
+        Emplace<T>(Pool, InValue);
         return ENBTAttributeOpResult::Success;
     }
 
     template <typename T>
-    ENBTAttributeOpResult OverriderToBaseTypeRef(const T& InValue) {
-        if (T* Ptr = Value.TryGet<T>(); Ptr) {
+    ENBTAttributeOpResult OverriderToBaseTypeRef(FNBTPayloadPool& Pool, const T& InValue) {
+        if (T* Ptr = TryGetPtr<T>(); Ptr) {
             if (InValue == *Ptr) {
                 return ENBTAttributeOpResult::SameAndNotChange;
             }
+            *Ptr = InValue;
+            return ENBTAttributeOpResult::Success;
         }
-        Value.Set<T>(InValue);
+        Emplace<T>(Pool, InValue);
         return ENBTAttributeOpResult::Success;
     }
 
     template <typename T>
-    ENBTAttributeOpResult OverriderToArrayType(const TArray<T>& InValue) {
-        if (TArray<T>* Ptr = Value.TryGet<TArray<T>>(); Ptr) {
+    ENBTAttributeOpResult OverriderToArrayType(FNBTPayloadPool& Pool, const TArray<T>& InValue) {
+        if (TArray<T>* Ptr = TryGetPtr<TArray<T>>(); Ptr) {
             if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
                 if (HelperCompareFloatArray(*Ptr, InValue)) return ENBTAttributeOpResult::SameAndNotChange;
             }
             
             if (*Ptr == InValue) return ENBTAttributeOpResult::SameAndNotChange;
+            *Ptr = InValue;
+            return ENBTAttributeOpResult::Success;
         }
-        Value.Set<TArray<T>>(InValue);
+        Emplace<TArray<T>>(Pool, InValue);
         return ENBTAttributeOpResult::Success;
     }
 
     const FNBTMapData* GetMapData() const {
-        return Value.TryGet<FNBTMapData>();
+        return TryGetPtr<FNBTMapData>();
     }
 
     FNBTMapData* GetMapData() {
-        return Value.TryGet<FNBTMapData>();
+        return TryGetPtr<FNBTMapData>();
     }
 
     const FNBTListData* GetListData() const {
-        return Value.TryGet<FNBTListData>();
+        return TryGetPtr<FNBTListData>();
     }
 
     FNBTListData* GetListData() {
-        return Value.TryGet<FNBTListData>();
+        return TryGetPtr<FNBTListData>();
     }
 
-    ENBTAttributeOpResult OverrideToEmptyMap() {
-        if (FNBTMapData* Ptr = Value.TryGet<FNBTMapData>(); Ptr) {
+    ENBTAttributeOpResult OverrideToEmptyMap(FNBTPayloadPool& Pool) {
+        if (FNBTMapData* Ptr = TryGetPtr<FNBTMapData>(); Ptr) {
             if (Ptr->Children.Num() <= 0) return ENBTAttributeOpResult::SameAndNotChange;
+            Ptr->Children.Empty();
+            return ENBTAttributeOpResult::Success;
         }
-        Value.Set<FNBTMapData>(FNBTMapData{});
+        Emplace<FNBTMapData>(Pool);
         return ENBTAttributeOpResult::Success;
     }
 
-    ENBTAttributeOpResult OverrideToEmptyList() {
-        if (FNBTListData* Ptr = Value.TryGet<FNBTListData>(); Ptr) {
+    ENBTAttributeOpResult OverrideToEmptyList(FNBTPayloadPool& Pool) {
+        if (FNBTListData* Ptr = TryGetPtr<FNBTListData>(); Ptr) {
             if (Ptr->Children.IsEmpty()) return ENBTAttributeOpResult::SameAndNotChange;
-            else Ptr->Children.Reset();
+            Ptr->Children.Empty();
+            return ENBTAttributeOpResult::Success;
         }
-        Value.Set<FNBTListData>(FNBTListData{});
+        Emplace<FNBTListData>(Pool);
         return ENBTAttributeOpResult::Success;
     }
 
     TOptional<int64> GetGenericInt() const {
         switch (GetType()) {
             case ENBTAttributeType::Boolean:
-                return Value.Get<bool>() ? 1 : 0;
+                return GetUnchecked<bool>() ? 1 : 0;
             case ENBTAttributeType::Int8:
-                return Value.Get<int8>();
+                return GetUnchecked<int8>();
             case ENBTAttributeType::Int16:
-                return Value.Get<int16>();
+                return GetUnchecked<int16>();
             case ENBTAttributeType::Int32:
-                return Value.Get<int32>();
+                return GetUnchecked<int32>();
             case ENBTAttributeType::Int64:
-                return Value.Get<int64>();
+                return GetUnchecked<int64>();
             default:
                 return {};
         }
@@ -235,9 +517,9 @@ private:
     TOptional<double> GetGenericDouble() const {
         switch (GetType()) {
             case ENBTAttributeType::Float:
-                return Value.Get<float>();
+                return GetUnchecked<float>();
             case ENBTAttributeType::Double:
-                return Value.Get<double>();
+                return GetUnchecked<double>();
             default:
                 return {};
         }
@@ -251,23 +533,23 @@ private:
 
         switch (GetType()) {
             case ENBTAttributeType::Boolean:
-                if (Value.Get<bool>() == (InValue != 0)) return ENBTAttributeOpResult::SameAndNotChange;
-                Value.Set<bool>((InValue != 0));
+                if (GetUnchecked<bool>() == (InValue != 0)) return ENBTAttributeOpResult::SameAndNotChange;
+                *GetPtrUnchecked<bool>() = (InValue != 0);
                 return ENBTAttributeOpResult::Success;
             case ENBTAttributeType::Int8:
-                Value.Set<int8>(FMath::Clamp(InValue,
+                *GetPtrUnchecked<int8>() = static_cast<int8>(FMath::Clamp(InValue,
                                              static_cast<int64>(std::numeric_limits<int8>::min()), static_cast<int64>(std::numeric_limits<int8>::max())));
                 return ENBTAttributeOpResult::Success;
             case ENBTAttributeType::Int16:
-                Value.Set<int16>(FMath::Clamp(InValue,
+                *GetPtrUnchecked<int16>() = static_cast<int16>(FMath::Clamp(InValue,
                                               static_cast<int64>(std::numeric_limits<int16>::min()), static_cast<int64>(std::numeric_limits<int16>::max())));
                 return ENBTAttributeOpResult::Success;
             case ENBTAttributeType::Int32:
-                Value.Set<int32>(FMath::Clamp(InValue,
+                *GetPtrUnchecked<int32>() = static_cast<int32>(FMath::Clamp(InValue,
                                               static_cast<int64>(std::numeric_limits<int32>::min()), static_cast<int64>(std::numeric_limits<int32>::max())));
                 return ENBTAttributeOpResult::Success;
             case ENBTAttributeType::Int64:
-                Value.Set<int64>(InValue);
+                *GetPtrUnchecked<int64>() = InValue;
                 return ENBTAttributeOpResult::Success;
             default:
                 return ENBTAttributeOpResult::NodeTypeMismatch;
@@ -280,24 +562,32 @@ private:
         if (FMath::IsNearlyEqual(Idx.GetValue(), InValue, 0.0001f)) return ENBTAttributeOpResult::SameAndNotChange;
         switch (GetType()) {
             case ENBTAttributeType::Float:
-                Value.Set<float>(static_cast<float>(InValue));
+                *GetPtrUnchecked<float>() = static_cast<float>(InValue);
                 return ENBTAttributeOpResult::Success;
             case ENBTAttributeType::Double:
-                Value.Set<double>(InValue);
+                *GetPtrUnchecked<double>() = InValue;
                 return ENBTAttributeOpResult::Success;
             default:
                 return ENBTAttributeOpResult::NodeTypeMismatch;
         }
     }
 
-    ENBTAttributeOpResult OverrideFromIfNotCompound(const FNBTAttribute& Other) {
+    ENBTAttributeOpResult OverrideFromIfNotCompound(FNBTPayloadPool& Pool, const FNBTAttribute& Other) {
         if (IsCompoundType()) return ENBTAttributeOpResult::NodeTypeMismatch; //如果是复合结构, 无法重载
         if (Other.IsCompoundType()) return ENBTAttributeOpResult::NodeTypeMismatch; //如果是复合结构, 无法重载
 
         if (EqualsValues(Other))
             return ENBTAttributeOpResult::SameAndNotChange;
 
-        Value = Other.Value; //基础值类型
+        //基础值类型
+        if (Other.IsEmpty()) {
+            Release(Pool);
+        } else {
+            Other.VisitValue([this, &Pool]<typename T0>(T0& OtherValue) {
+                using T = std::decay_t<T0>;
+                Emplace<T>(Pool, OtherValue);
+            });
+        }
         return ENBTAttributeOpResult::Success;
     }
 
@@ -305,7 +595,7 @@ private:
 
     bool EqualsValues(const FNBTAttribute& Other) const;
 
-    void SerializeNBTData(FArchive& Ar, bool NetWorkMode);
+    void SerializeNBTData(FArchive& Ar, bool NetWorkMode, FNBTPayloadPool& Pool);
 
     template <typename T>
     static bool HelperCompareFloatArray(const TArray<T>& A, const TArray<T>& B) {
@@ -315,4 +605,6 @@ private:
         }
         return true;
     }
-};
\ No newline at end of file
+};
+
+static_assert(sizeof(FNBTAttribute) <= 24, "FNBTAttribute should stay a compact tagged node");
@@ -4,14 +4,32 @@
 #include "UObject/Object.h"
 #include "NBTHelper.h"
 
+// 宽ID模式: 由 NBTSystem.Build.cs 中的 bUseWideAttributeID 控制
+// 0: 16位索引 + 16位代, 最多65534个节点
+// 1: 24位索引 + 16位代(共64位存储), 最多16777214个节点
+#ifndef ARZ_NBT_WIDE_ID
+#define ARZ_NBT_WIDE_ID 0
+#endif
+
 struct FNBTAttributeID {
-    static constexpr uint16 InvalidIndex = 0xFFFF;
+#if ARZ_NBT_WIDE_ID
+    using IndexType = uint32;
+    static constexpr uint32 IndexBits = 24;
+#else
+    using IndexType = uint16;
+    static constexpr uint32 IndexBits = 16;
+#endif
+    using GenerationType = uint16;
+
+    static constexpr IndexType InvalidIndex = static_cast<IndexType>((1ULL << IndexBits) - 1);
+
+    static constexpr uint32 MaxNodes = InvalidIndex - 1; // 最后一个索引用于有效性校验
     
-    uint16 Index;      // 支持65534个节点
-    uint16 Generation;  // 256个生成代，防止ID重用问题
+    IndexType Index;      // 窄模式支持65534个节点, 宽模式支持16777214个节点
+    GenerationType Generation;  // 生成代，防止ID重用问题
     
     FNBTAttributeID() : Index(InvalidIndex), Generation(0) {}
-    explicit FNBTAttributeID(uint16 InIndex, uint16 InGen) : Index(InIndex), Generation(InGen) {}
+    explicit FNBTAttributeID(IndexType InIndex, GenerationType InGen) : Index(InIndex), Generation(InGen) {}
 
     FNBTAttributeID(const FNBTAttributeID& Other) : Index(Other.Index), Generation(Other.Generation) {}
 
@@ -28,11 +46,15 @@ struct FNBTAttributeID {
     }
     
     friend uint32 GetTypeHash(const FNBTAttributeID& ID) {
+#if ARZ_NBT_WIDE_ID
+        return HashCombineFast(static_cast<uint32>(ID.Index), static_cast<uint32>(ID.Generation));
+#else
         return (static_cast<uint32>(ID.Index) << 16) | static_cast<uint32>(ID.Generation);
+#endif
     }
 
     FString ToString() const {
-        return FString::Printf(TEXT("ID[%d:%d]"), Index, Generation);
+        return FString::Printf(TEXT("ID[%u:%u]"), static_cast<uint32>(Index), static_cast<uint32>(Generation));
     }
     
     friend FArchive& operator<<(FArchive& Ar, FNBTAttributeID& ID) {
@@ -106,6 +106,36 @@
         "* @warning 此操作会无条件覆盖现有数据,可能会影响其他需要和此数据交互的程序模块工作！\n" \
     )
 
+/**
+ * @brief 为Map批量读取绑定一个类型特化 (MapTryGet<TypeName>Batch)
+ * @param TypeName      用于构成函数名的类型标识, 例如 Int32, GenericDouble
+ * @param CppType       实际的C++类型, 例如 int32, double
+ * @param AsType        在AngelScript脚本中使用的类型签名, 对float应为float32
+ * @param DocName       文档中显示的类型名称
+ */
+#define BIND_NBT_ACCESSOR_MAP_BATCH(TypeName, CppType, AsType, DocName) \
+    FArzNBTDataAccessor_.Method("FNBTAttributeOpResultDetail MapTryGet" #TypeName "Batch(const TArray<FName>& Keys, TArray<TOptional<" #AsType ">>& OutValues) const", \
+                                METHODPR_TRIVIAL(FNBTAttributeOpResultDetail, FNBTDataAccessor, MapTryGet##TypeName##Batch, (const TArray<FName>&, TArray<TOptional<CppType>>&)const)); \
+    SCRIPT_BIND_DOCUMENTATION( \
+        "* 批量读取当前Map节点下多个键的" DocName "值, 当前节点只解析一次。\n" \
+        "* @param Keys 要读取的键名列表。\n" \
+        "* @param OutValues [输出参数] 与Keys一一对应, 键不存在或类型不匹配时为空。重复使用同一数组时不会重新分配。\n" \
+        "* @return 返回操作结果对象。当前节点不存在或不是Map时返回对应错误, 此时所有输出为空。\n" \
+    )
+
+/**
+ * @brief 为相对路径批量读取绑定一个类型特化 (TryGet<TypeName>Batch), 参数同 BIND_NBT_ACCESSOR_MAP_BATCH
+ */
+#define BIND_NBT_ACCESSOR_PATH_BATCH(TypeName, CppType, AsType, DocName) \
+    FArzNBTDataAccessor_.Method("FNBTAttributeOpResultDetail TryGet" #TypeName "Batch(const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<" #AsType ">>& OutValues) const", \
+                                METHODPR_TRIVIAL(FNBTAttributeOpResultDetail, FNBTDataAccessor, TryGet##TypeName##Batch, (const TArray<FNBTCompiledPath>&, TArray<TOptional<CppType>>&)const)); \
+    SCRIPT_BIND_DOCUMENTATION( \
+        "* 批量读取当前节点下多个相对路径的" DocName "值, 相邻路径的公共前缀只解析一次, 路径按前缀排序时效果最好。\n" \
+        "* @param RelativePaths 相对于当前节点的预编译路径列表。\n" \
+        "* @param OutValues [输出参数] 与RelativePaths一一对应, 路径不存在或类型不匹配时为空。重复使用同一数组时不会重新分配。\n" \
+        "* @return 返回操作结果对象。当前节点不存在时返回对应错误, 此时所有输出为空。\n" \
+    )
+
 
 AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTAttributeOperatorResultDetail(FAngelscriptBinds::EOrder::Late, [] {
     auto FArzNBTAttributeOperatorResultDetail_ = FAngelscriptBinds::ExistingClass("FNBTAttributeOpResultDetail");
@@ -165,6 +195,14 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTContainer(FAngelscriptB
         "* 访问器提供了安全的路径访问方式，支持链式调用来访问嵌套数据\n"
     )
 
+    FArzNBTContainer_.Method("FNBTDataAccessor GetAccessor(const FNBTCompiledPath& CompiledPath) const",
+                             METHODPR_TRIVIAL(FNBTDataAccessor, FNBTContainer, GetAccessor, (const FNBTCompiledPath&) const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 通过预编译路径获取数据访问器\n"
+        "* @param CompiledPath 由 FNBTCompiledPath::Compile 编译的路径\n"
+        "* @return 指向该路径的访问器，解析结果在结构未变化时直接复用，不会重新逐段查找\n"
+    )
+
     FArzNBTContainer_.Method("void Reset()", METHODPR_TRIVIAL(void, FNBTContainer, Reset, ()));
     SCRIPT_BIND_DOCUMENTATION(
         "* 重置容器到初始状态\n"
@@ -180,6 +218,72 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTContainer(FAngelscriptB
         "* 原有数据将被完全替换\n"
     )
 
+    FArzNBTContainer_.Method("void SetUsePayloadArena(bool bUseArena)", METHODPR_TRIVIAL(void, FNBTContainer, SetUsePayloadArena, (bool)));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 设置是否使用负载竞技场\n"
+        "* @param bUseArena 开启后外置负载从整块内存中切分，Reset/Clear/CopyFrom 时整体释放\n"
+        "* 设置在下一次 Reset 或 CopyFrom 时生效，适合频繁整体重建的临时容器\n"
+        "* 只覆盖Map子项表、软路径、双精度向量等外置负载，字符串与数组的缓冲区仍逐个分配和释放\n"
+    )
+
+    FArzNBTContainer_.Method("bool IsUsingPayloadArena() const", METHODPR_TRIVIAL(bool, FNBTContainer, IsUsingPayloadArena, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 当前是否正在使用负载竞技场\n"
+        "* @return 已生效的竞技场模式，调用 SetUsePayloadArena 后在下一次 Reset 前仍返回旧值\n"
+    )
+
+    FArzNBTContainer_.Method("bool CompactIncremental(float32 TimeBudgetMs)", METHODPR_TRIVIAL(bool, FNBTContainer, CompactIncremental, (float)));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 增量整理容器内存\n"
+        "* @param TimeBudgetMs 本次调用的时间预算（毫秒）\n"
+        "* @return 整理完成返回true，否则需要在之后的帧中继续调用\n"
+        "* 把尾部稀疏块中的节点搬到前部空洞并释放尾部空块，适合长期存在、反复增删的容器\n"
+        "* 被搬移节点的ID会改变，已有访问器会自动重新解析路径\n"
+        "* 写入批次未提交时不进行整理，直接返回false\n"
+    )
+
+    FArzNBTContainer_.Method("bool IsCompacting() const", METHODPR_TRIVIAL(bool, FNBTContainer, IsCompacting, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 是否有未完成的增量整理\n"
+    )
+
+    FArzNBTContainer_.Method("void BeginWriteBatch()", METHODPR_TRIVIAL(void, FNBTContainer, BeginWriteBatch, ()));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 开始批量写入, 必须与 CommitWriteBatch 成对调用\n"
+        "* 期间的写操作不再各自更新容器数据版本和子树版本, 提交时统一更新一次\n"
+        "* 适合一次写入同一父节点下大量字段的场景, 可以嵌套, 以最外层提交为准\n"
+        "* 帧末仍未提交的批次会被所属组件强制提交并输出错误日志\n"
+    )
+
+    FArzNBTContainer_.Method("void CommitWriteBatch()", METHODPR_TRIVIAL(void, FNBTContainer, CommitWriteBatch, ()));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 提交批量写入\n"
+        "* 每个被修改节点的祖先只冒泡一次子树版本, 容器数据版本只增加一次\n"
+    )
+
+    FArzNBTContainer_.Method("bool IsInWriteBatch() const", METHODPR_TRIVIAL(bool, FNBTContainer, IsInWriteBatch, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 当前是否处于批量写入中\n"
+    )
+
+    FArzNBTContainer_.Method("void SetLazySubtreeVersion(bool bLazy)", METHODPR_TRIVIAL(void, FNBTContainer, SetLazySubtreeVersion, (bool)));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 设置是否延迟传播子树版本\n"
+        "* @param bLazy 开启后写操作只记录被修改的节点，读取子树版本前统一沿父链传播\n"
+        "* 适合高频写入、每帧只检查一次 IsSubtreeChanged 的容器，关闭时立即传播尚未处理的修改\n"
+    )
+
+    FArzNBTContainer_.Method("bool IsLazySubtreeVersion() const", METHODPR_TRIVIAL(bool, FNBTContainer, IsLazySubtreeVersion, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 当前是否延迟传播子树版本\n"
+    )
+
+    FArzNBTContainer_.Method("void FlushSubtreeVersions() const", METHODPR_TRIVIAL(void, FNBTContainer, FlushSubtreeVersions, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 立即传播延迟模式下尚未处理的子树版本\n"
+        "* 访问器读取子树版本时会自动调用，通常只需在帧末手动调用一次\n"
+    )
+
     FArzNBTContainer_.Method("int32 GetNodeCount() const", METHODPR_TRIVIAL(int32, FNBTContainer, GetNodeCount, () const));
     SCRIPT_BIND_DOCUMENTATION(
         "* 获取容器中活跃节点的总数\n"
@@ -239,6 +343,57 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTContainer(FAngelscriptB
     }
 });
 
+AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTCompiledPath(FAngelscriptBinds::EOrder::Late, [] {
+    auto FArzNBTCompiledPath_ = FAngelscriptBinds::ExistingClass("FNBTCompiledPath");
+
+    FArzNBTCompiledPath_.Method("bool IsValid() const", METHODPR_TRIVIAL(bool, FNBTCompiledPath, IsValid, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 路径是否编译成功\n"
+    )
+
+    FArzNBTCompiledPath_.Method("int32 Num() const", METHODPR_TRIVIAL(int32, FNBTCompiledPath, Num, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 获取路径段数量，根路径为0\n"
+    )
+
+    FArzNBTCompiledPath_.Method("FNBTCompiledPath Key(FName InKey) const", METHODPR_TRIVIAL(FNBTCompiledPath, FNBTCompiledPath, Key, (FName) const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 构建器：追加一段Map键\n"
+        "* @param InKey Map键\n"
+        "* @return 新的预编译路径，原路径不变\n"
+    )
+
+    FArzNBTCompiledPath_.Method("FNBTCompiledPath Index(int32 InIndex) const", METHODPR_TRIVIAL(FNBTCompiledPath, FNBTCompiledPath, Index, (int32) const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 构建器：追加一段List下标\n"
+        "* @param InIndex List下标\n"
+        "* @return 新的预编译路径，原路径不变\n"
+    )
+
+    FArzNBTCompiledPath_.Method("FNBTDataAccessor Resolve(const FNBTContainer& Container) const",
+                                METHODPR_TRIVIAL(FNBTDataAccessor, FNBTCompiledPath, Resolve, (const FNBTContainer&) const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 在指定容器上解析路径\n"
+        "* @param Container 目标容器，同一个预编译路径可以在任意容器上使用\n"
+        "* @return 指向该路径的访问器，解析结果按容器结构版本缓存\n"
+    )
+
+    FArzNBTCompiledPath_.Method("FString ToString() const", METHODPR_TRIVIAL(FString, FNBTCompiledPath, ToString, () const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 获取路径的字符串表示，例如 Inventory[3].Name\n"
+    )
+
+    {
+        FAngelscriptBinds::FNamespace ns("FNBTCompiledPath");
+        FAngelscriptBinds::BindGlobalFunction("FNBTCompiledPath Compile(const FString& PathString)", FUNC_TRIVIAL(FNBTCompiledPath::Compile));
+        SCRIPT_BIND_DOCUMENTATION(
+            "* 编译路径字符串，只需编译一次，之后可在任意容器上反复解析\n"
+            "* @param PathString 路径，例如 \"Stats.Health\" 或 \"Inventory[3].Name\"，空字符串表示根\n"
+            "* @return 预编译路径，语法错误时返回无效路径并输出警告\n"
+        )
+    }
+});
+
 AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTDataAccessor(FAngelscriptBinds::EOrder::Late, [] {
     auto FArzNBTDataAccessor_ = FAngelscriptBinds::ExistingClass("FNBTDataAccessor");
 
@@ -565,6 +720,22 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTDataAccessor(FAngelscri
         "* @note 这是MakeAccessorFromMap的便捷版本,直接返回数组而不是通过输出参数。\n"
     )
 
+    BIND_NBT_ACCESSOR_MAP_BATCH(GenericInt, int64, int64, "整数(自动转换为int64)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(GenericDouble, double, double, "浮点数(自动转换为double)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(Bool, bool, bool, "布尔值(bool)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(Int32, int32, int32, "32位整数(int32)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(Float, float, float32, "单精度浮点数(float)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(Name, FName, FName, "名称(FName)");
+    BIND_NBT_ACCESSOR_MAP_BATCH(String, FString, FString, "字符串(FString)");
+
+    BIND_NBT_ACCESSOR_PATH_BATCH(GenericInt, int64, int64, "整数(自动转换为int64)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(GenericDouble, double, double, "浮点数(自动转换为double)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(Bool, bool, bool, "布尔值(bool)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(Int32, int32, int32, "32位整数(int32)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(Float, float, float32, "单精度浮点数(float)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(Name, FName, FName, "名称(FName)");
+    BIND_NBT_ACCESSOR_PATH_BATCH(String, FString, FString, "字符串(FString)");
+
     FArzNBTDataAccessor_.Method("FNBTAttributeOpResultDetail ListGetSize(int32& Size) const",
                                 METHODPR_TRIVIAL(FNBTAttributeOpResultDetail, FNBTDataAccessor, ListGetSize, (int32&)const));
     SCRIPT_BIND_DOCUMENTATION(
@@ -751,6 +922,24 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FArzNBTDataAccessor(FAngelscri
         "* @note 路径中的List索引会以[index]形式表示，如\"Root -> Container -> [2] -> Name\"。\n"
     )
 
+    FArzNBTDataAccessor_.Method("FNBTAttributeOpResultDetail SetReplicateCondition(ENBTReplicateCondition Condition, int32 TeamID = -1) const",
+                                METHODPR_TRIVIAL(FNBTAttributeOpResultDetail, FNBTDataAccessor, SetReplicateCondition, (ENBTReplicateCondition, int32)const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 为当前路径的最后一个Map键设置网络同步条件, 作用于该键下的整个子树。\n"
+        "* 服务器为每个连接单独过滤差分, 不满足条件的连接收不到该子树, 条件变化后已连接的客户端会相应增删子树。\n"
+        "* @param Condition 同步条件, All表示移除条件; Custom需要判定委托, 只能在C++中设置。\n"
+        "* @param TeamID [可选] Team条件下允许接收的队伍, 连接的队伍由组件的队伍解析委托给出。\n"
+        "* @return 返回操作结果; 路径最后一段不是Map键或父Map不存在时失败。\n"
+        "* @note 键本身可以暂不存在, 之后创建的子树同样受条件约束。\n"
+    )
+
+    FArzNBTDataAccessor_.Method("ENBTReplicateCondition GetReplicateCondition() const",
+                                METHODPR_TRIVIAL(ENBTReplicateCondition, FNBTDataAccessor, GetReplicateCondition, ()const));
+    SCRIPT_BIND_DOCUMENTATION(
+        "* 获取当前路径的最后一个Map键上设置的网络同步条件。\n"
+        "* @return 返回同步条件, 没有设置或路径无效时返回All。\n"
+    )
+
     FArzNBTDataAccessor_.Method("FNBTAttributeOpResultDetail TryCopyFrom(const FNBTDataAccessor& Source) const",
                                 METHODPR_TRIVIAL(FNBTAttributeOpResultDetail, FNBTDataAccessor, TryCopyFrom, (const FNBTDataAccessor&)const));
     SCRIPT_BIND_DOCUMENTATION(
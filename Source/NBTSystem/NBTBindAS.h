@@ -3,4 +3,5 @@
 #include "NBTCommon.h"
 #include "NBTAttribute.h"
 #include "NBTContainer.h"
-#include "NBTAccessor.h"
\ No newline at end of file
+#include "NBTAccessor.h"
+#include "NBTCompiledPath.h"
\ No newline at end of file
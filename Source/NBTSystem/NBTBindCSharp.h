@@ -44,6 +44,116 @@ UCLASS(Blueprintable, BlueprintType)
          const_cast<FNBTContainer*>(&Target)->CopyFrom(Other);
      }
 
+     /**
+      * 设置是否使用负载竞技场。
+      * 开启后外置负载从整块内存中切分，Reset/CopyFrom 时整体释放，适合频繁整体重建的临时容器。
+      * @param Target 目标NBT容器引用
+      * @param bUseArena 是否使用竞技场
+      * @note 设置在下一次 Reset 或 CopyFrom 时生效
+      * @note 只覆盖Map子项表、软路径、双精度向量等外置负载，字符串与数组的缓冲区仍逐个分配和释放
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static void SetUsePayloadArena(const FNBTContainer& Target, bool bUseArena) {
+         const_cast<FNBTContainer*>(&Target)->SetUsePayloadArena(bUseArena);
+     }
+
+     /**
+      * 当前是否正在使用负载竞技场。
+      * @param Target 要查询的NBT容器引用
+      * @return 已生效的竞技场模式
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool IsUsingPayloadArena(const FNBTContainer& Target) {
+         return Target.IsUsingPayloadArena();
+     }
+
+     /**
+      * 增量整理容器内存。
+      * 把尾部稀疏块中的节点搬到前部空洞并释放尾部空块，可跨帧反复调用。
+      * 被搬移节点的ID会改变，已有访问器会自动重新解析路径。
+      * 写入批次未提交时不进行整理，直接返回false。
+      * @param Target 目标NBT容器引用
+      * @param TimeBudgetMs 本次调用的时间预算（毫秒）
+      * @return 整理完成返回true，否则需要在之后的帧中继续调用
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool CompactIncremental(const FNBTContainer& Target, float TimeBudgetMs) {
+         return const_cast<FNBTContainer*>(&Target)->CompactIncremental(TimeBudgetMs);
+     }
+
+     /**
+      * 是否有未完成的增量整理。
+      * @param Target 要查询的NBT容器引用
+      * @return 正在整理返回true
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool IsCompacting(const FNBTContainer& Target) {
+         return Target.IsCompacting();
+     }
+
+     /**
+      * 开始批量写入，必须与CommitWriteBatch成对调用。
+      * 期间的写操作不再各自更新容器数据版本和子树版本，提交时统一更新一次；可以嵌套，以最外层提交为准。
+      * 帧末仍未提交的批次会被所属组件强制提交并输出错误日志。
+      * @param Target 要写入的NBT容器引用
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static void BeginWriteBatch(const FNBTContainer& Target) {
+         const_cast<FNBTContainer*>(&Target)->BeginWriteBatch();
+     }
+
+     /**
+      * 提交批量写入。
+      * 每个被修改节点的祖先只冒泡一次子树版本，容器数据版本只增加一次。
+      * @param Target 要提交的NBT容器引用
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static void CommitWriteBatch(const FNBTContainer& Target) {
+         const_cast<FNBTContainer*>(&Target)->CommitWriteBatch();
+     }
+
+     /**
+      * 当前是否处于批量写入中。
+      * @param Target 要查询的NBT容器引用
+      * @return 处于批量写入中返回true
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool IsInWriteBatch(const FNBTContainer& Target) {
+         return Target.IsInWriteBatch();
+     }
+
+     /**
+      * 设置是否延迟传播子树版本。
+      * 开启后写操作只记录被修改的节点，读取子树版本（IsSubtreeChanged/MarkSubtree）前统一沿父链传播，适合高频写入、每帧只检查一次的容器。
+      * @param Target 目标NBT容器引用
+      * @param bLazy 是否延迟传播
+      * @note 关闭时会立即传播尚未处理的修改
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static void SetLazySubtreeVersion(const FNBTContainer& Target, bool bLazy) {
+         const_cast<FNBTContainer*>(&Target)->SetLazySubtreeVersion(bLazy);
+     }
+
+     /**
+      * 当前是否延迟传播子树版本。
+      * @param Target 要查询的NBT容器引用
+      * @return 处于延迟模式返回true
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool IsLazySubtreeVersion(const FNBTContainer& Target) {
+         return Target.IsLazySubtreeVersion();
+     }
+
+     /**
+      * 立即传播延迟模式下尚未处理的子树版本。
+      * 访问器读取子树版本时会自动调用，通常只需在帧末手动调用一次。
+      * @param Target 目标NBT容器引用
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static void FlushSubtreeVersions(const FNBTContainer& Target) {
+         Target.FlushSubtreeVersions();
+     }
+
      /**
       * 获取容器的数据版本号。
       * 数据版本号在容器内容发生变化时会自动递增，用于网络同步和变化检测。
@@ -88,6 +198,18 @@ UCLASS(Blueprintable, BlueprintType)
      static FNBTDataAccessor GetAccessor(const FNBTContainer& Target) {
          return const_cast<FNBTContainer*>(&Target)->GetAccessor();
      }
+
+     /**
+      * 通过预编译路径获取数据访问器。
+      * 解析结果按容器结构版本缓存，结构未变化时不会重新逐段查找。
+      * @param Target 要获取访问器的NBT容器引用
+      * @param CompiledPath 预编译路径
+      * @return 指向该路径的数据访问器
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTDataAccessor GetAccessorByCompiledPath(const FNBTContainer& Target, const FNBTCompiledPath& CompiledPath) {
+         return Target.GetAccessor(CompiledPath);
+     }
      
      /**
       * 将容器内容转换为可读的字符串表示。
@@ -136,6 +258,84 @@ UCLASS(Blueprintable, BlueprintType)
      }
  };
 
+ UCLASS(Blueprintable, BlueprintType)
+ class NBTSYSTEM_API UNBTSystemCompiledPathCSharpBind : public UBlueprintFunctionLibrary {
+     GENERATED_BODY()
+ public:
+     /**
+      * 编译路径字符串。只需编译一次，之后可在任意容器上反复解析。
+      * @param PathString 路径，例如 "Stats.Health" 或 "Inventory[3].Name"，空字符串表示根
+      * @return 预编译路径，语法错误时返回无效路径并输出警告
+      */
+     UFUNCTION()
+     static FNBTCompiledPath CompileNBTPath(const FString& PathString) {
+         return FNBTCompiledPath::Compile(PathString);
+     }
+
+     /**
+      * 路径是否编译成功。
+      * @param Target 预编译路径
+      * @return 编译成功返回true
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static bool IsValid(const FNBTCompiledPath& Target) {
+         return Target.IsValid();
+     }
+
+     /**
+      * 获取路径段数量，根路径为0。
+      * @param Target 预编译路径
+      * @return 路径段数量
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static int32 Num(const FNBTCompiledPath& Target) {
+         return Target.Num();
+     }
+
+     /**
+      * 构建器：追加一段Map键。
+      * @param Target 预编译路径
+      * @param InKey Map键
+      * @return 新的预编译路径，原路径不变
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTCompiledPath Key(const FNBTCompiledPath& Target, FName InKey) {
+         return Target.Key(InKey);
+     }
+
+     /**
+      * 构建器：追加一段List下标。
+      * @param Target 预编译路径
+      * @param InIndex List下标
+      * @return 新的预编译路径，原路径不变
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTCompiledPath Index(const FNBTCompiledPath& Target, int32 InIndex) {
+         return Target.Index(InIndex);
+     }
+
+     /**
+      * 在指定容器上解析路径。
+      * @param Target 预编译路径
+      * @param Container 目标容器，同一个预编译路径可以在任意容器上使用
+      * @return 指向该路径的访问器，解析结果按容器结构版本缓存
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTDataAccessor Resolve(const FNBTCompiledPath& Target, const FNBTContainer& Container) {
+         return Target.Resolve(Container);
+     }
+
+     /**
+      * 获取路径的字符串表示。
+      * @param Target 预编译路径
+      * @return 例如 Inventory[3].Name
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FString ToString(const FNBTCompiledPath& Target) {
+         return Target.ToString();
+     }
+ };
+
  UCLASS(Blueprintable, BlueprintType)
  class NBTSYSTEM_API UNBTSystemAccessorCSharpBind : public UBlueprintFunctionLibrary {
      GENERATED_BODY()
@@ -1647,6 +1847,188 @@ UCLASS(Blueprintable, BlueprintType)
          return Target.MakeAccessorFromMapNow();
      }
 
+     /**
+      * 批量读取Map类型节点下多个键的整数值(自动转换为int64)。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetGenericIntBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<int64>>& OutValues) {
+         return Target.MapTryGetGenericIntBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的浮点值(自动转换为double)。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetGenericDoubleBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<double>>& OutValues) {
+         return Target.MapTryGetGenericDoubleBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的布尔值。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetBoolBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<bool>>& OutValues) {
+         return Target.MapTryGetBoolBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的int32值。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetInt32Batch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<int32>>& OutValues) {
+         return Target.MapTryGetInt32Batch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的float值。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetFloatBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<float>>& OutValues) {
+         return Target.MapTryGetFloatBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的FName值。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetNameBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<FName>>& OutValues) {
+         return Target.MapTryGetNameBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取Map类型节点下多个键的字符串值。
+      * 当前节点只解析一次，之后直接在子表中查找各个键。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param Keys 要读取的键名列表
+      * @param OutValues 输出参数，与Keys一一对应，键不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在或不是Map时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail MapTryGetStringBatch(const FNBTDataAccessor& Target, const TArray<FName>& Keys, TArray<TOptional<FString>>& OutValues) {
+         return Target.MapTryGetStringBatch(Keys, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的整数值(自动转换为int64)。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetGenericIntBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int64>>& OutValues) {
+         return Target.TryGetGenericIntBatch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的浮点值(自动转换为double)。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetGenericDoubleBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<double>>& OutValues) {
+         return Target.TryGetGenericDoubleBatch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的布尔值。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetBoolBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<bool>>& OutValues) {
+         return Target.TryGetBoolBatch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的int32值。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetInt32Batch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<int32>>& OutValues) {
+         return Target.TryGetInt32Batch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的float值。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetFloatBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<float>>& OutValues) {
+         return Target.TryGetFloatBatch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的FName值。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetNameBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FName>>& OutValues) {
+         return Target.TryGetNameBatch(RelativePaths, OutValues);
+     }
+
+     /**
+      * 批量读取当前节点下多个相对路径的字符串值。
+      * 相邻路径的公共前缀只解析一次，路径按前缀排序时效果最好。
+      * @param Target 要读取的NBT数据访问器引用
+      * @param RelativePaths 相对于当前节点的预编译路径列表
+      * @param OutValues 输出参数，与RelativePaths一一对应，路径不存在或类型不匹配时为空；重复使用同一数组时不会重新分配
+      * @return 操作结果详情，当前节点不存在时返回失败且所有输出为空
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail TryGetStringBatch(const FNBTDataAccessor& Target, const TArray<FNBTCompiledPath>& RelativePaths, TArray<TOptional<FString>>& OutValues) {
+         return Target.TryGetStringBatch(RelativePaths, OutValues);
+     }
+
      /**
      * 获取List类型节点中的元素数量。
      * 仅对List类型节点有效，返回List中子节点的总数量。
@@ -1812,6 +2194,29 @@ UCLASS(Blueprintable, BlueprintType)
          return Target.GetPreviewPath();
      }
 
+     /**
+      * 为当前路径的最后一个Map键设置网络同步条件。
+      * 条件作用于该键下的整个子树, 服务器为每个连接单独过滤差分, 条件变化后已连接的客户端会相应增删子树。
+      * @param Target 指向Map键的NBT数据访问器引用
+      * @param Condition 同步条件, All表示移除条件; Custom需要判定委托, 只能在C++中设置
+      * @param TeamID Team条件下允许接收的队伍, 连接的队伍由组件的队伍解析委托给出
+      * @return 操作结果; 路径最后一段不是Map键或父Map不存在时失败
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static FNBTAttributeOpResultDetail SetReplicateCondition(const FNBTDataAccessor& Target, ENBTReplicateCondition Condition, int32 TeamID = -1) {
+         return Target.SetReplicateCondition(Condition, TeamID);
+     }
+
+     /**
+      * 获取当前路径的最后一个Map键上设置的网络同步条件。
+      * @param Target 指向Map键的NBT数据访问器引用
+      * @return 同步条件, 没有设置或路径无效时返回All
+      */
+     UFUNCTION( meta=(ExtensionMethod, ScriptMethod))
+     static ENBTReplicateCondition GetReplicateCondition(const FNBTDataAccessor& Target) {
+         return Target.GetReplicateCondition();
+     }
+
 
      /**
       * 尝试从源访问器复制数据到当前访问器。
@@ -0,0 +1,89 @@
+﻿#include "NBTChunkPool.h"
+
+#include "NBTAllocator.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+static int32 GNBTChunkPoolMaxCachedChunks = FNBTChunkPool::DEFAULT_MAX_CACHED_CHUNKS;
+
+static FAutoConsoleVariableRef CVarNBTChunkPoolMaxCachedChunks(
+    TEXT("NBT.ChunkPool.MaxCachedChunks"),
+    GNBTChunkPoolMaxCachedChunks,
+    TEXT("进程级NBT块池最多缓存的块数量, 超出后归还的块直接释放"),
+    ECVF_Default);
+
+FNBTChunkPool& FNBTChunkPool::Get() {
+    // 不随静态析构销毁, 避免静态容器在池之后析构时归还块; 缓存的块在模块卸载时释放
+    static FNBTChunkPool* Instance = new FNBTChunkPool();
+    return *Instance;
+}
+
+FNBTChunkPool::~FNBTChunkPool() {
+    Trim();
+}
+
+FAttributeChunk* FNBTChunkPool::Acquire(uint32 ChunkIndex, FNBTPayloadPool* PayloadPool, const FNBTChunkSlotWatermark* Watermark) {
+    FAttributeChunk* Chunk = nullptr;
+    {
+        FScopeLock Lock(&Mutex);
+        if (FreeChunks.Num() > 0) {
+            Chunk = FreeChunks.Pop();
+            Stats.CachedChunks = FreeChunks.Num();
+            Stats.Hits++;
+        } else {
+            Stats.Misses++;
+        }
+    }
+
+    if (Chunk) {
+        Chunk->Reinitialize(ChunkIndex, PayloadPool, Watermark);
+        return Chunk;
+    }
+    return new FAttributeChunk(ChunkIndex, PayloadPool, Watermark);
+}
+
+void FNBTChunkPool::Release(FAttributeChunk* Chunk) {
+    if (!Chunk) return;
+    Chunk->ReleaseAllSlots(false); // 在锁外释放负载, 负载池属于调用方容器
+
+    {
+        FScopeLock Lock(&Mutex);
+        if (FreeChunks.Num() < GNBTChunkPoolMaxCachedChunks) {
+            FreeChunks.Add(Chunk);
+            Stats.CachedChunks = FreeChunks.Num();
+            Stats.PeakCachedChunks = FMath::Max(Stats.PeakCachedChunks, Stats.CachedChunks);
+            Stats.Returns++;
+            return;
+        }
+        Stats.Discards++;
+    }
+    delete Chunk;
+}
+
+void FNBTChunkPool::SetHighWaterMark(int32 InMaxCachedChunks) {
+    FScopeLock Lock(&Mutex);
+    GNBTChunkPoolMaxCachedChunks = FMath::Max(0, InMaxCachedChunks);
+    TrimToLocked(GNBTChunkPoolMaxCachedChunks);
+}
+
+int32 FNBTChunkPool::GetHighWaterMark() const {
+    FScopeLock Lock(&Mutex);
+    return GNBTChunkPoolMaxCachedChunks;
+}
+
+void FNBTChunkPool::Trim() {
+    FScopeLock Lock(&Mutex);
+    TrimToLocked(0);
+}
+
+FNBTChunkPoolStats FNBTChunkPool::GetStats() const {
+    FScopeLock Lock(&Mutex);
+    return Stats;
+}
+
+void FNBTChunkPool::TrimToLocked(int32 MaxCachedChunks) {
+    while (FreeChunks.Num() > MaxCachedChunks) {
+        delete FreeChunks.Pop();
+    }
+    Stats.CachedChunks = FreeChunks.Num();
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+struct FAttributeChunk;
+struct FNBTChunkSlotWatermark;
+class FNBTPayloadPool;
+
+struct FNBTChunkPoolStats {
+    uint64 Hits = 0;        // 从缓存中取得块的次数
+    uint64 Misses = 0;      // 缓存为空, 需要新建块的次数
+    uint64 Returns = 0;     // 归还后被缓存的次数
+    uint64 Discards = 0;    // 归还时超过上限被直接释放的次数
+    int32 CachedChunks = 0;
+    int32 PeakCachedChunks = 0;
+};
+
+// 进程级块池: 缓存各容器归还的 FAttributeChunk(含属性缓冲), 供所有容器复用
+// 大量生成/销毁带NBT的Actor时不再反复向系统申请大块对齐内存
+// 线程安全, 缓存数量受上限约束, 可通过 NBT.ChunkPool.MaxCachedChunks 调整
+class NBTSYSTEM_API FNBTChunkPool {
+public:
+    static constexpr int32 DEFAULT_MAX_CACHED_CHUNKS = 256;
+
+    static FNBTChunkPool& Get();
+
+    FNBTChunkPool() = default;
+    FNBTChunkPool(const FNBTChunkPool&) = delete;
+    FNBTChunkPool& operator=(const FNBTChunkPool&) = delete;
+    ~FNBTChunkPool();
+
+    // 取得一个空块, 占用/版本/父链接已清零, 代数与结构版本取自 Watermark(为空时清零)
+    FAttributeChunk* Acquire(uint32 ChunkIndex, FNBTPayloadPool* PayloadPool, const FNBTChunkSlotWatermark* Watermark);
+
+    // 归还块, 块内剩余节点会先被释放
+    void Release(FAttributeChunk* Chunk);
+
+    // 缓存上限, 调低时立即释放多余的块
+    void SetHighWaterMark(int32 InMaxCachedChunks);
+    int32 GetHighWaterMark() const;
+
+    // 释放所有缓存的块
+    void Trim();
+
+    FNBTChunkPoolStats GetStats() const;
+
+private:
+    void TrimToLocked(int32 MaxCachedChunks);
+
+    mutable FCriticalSection Mutex;
+    TArray<FAttributeChunk*> FreeChunks;
+    FNBTChunkPoolStats Stats;
+};
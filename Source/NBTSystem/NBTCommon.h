@@ -146,6 +146,16 @@ struct FNBTAttributeOpResultDetail {
     }
 };
 
+// 子树同步条件, 挂在Map键上, 见 FNBTDataAccessor::SetReplicateCondition
+UENUM(BlueprintType)
+enum class ENBTReplicateCondition : uint8 {
+    All,
+    SkipOwner,
+    OwnerOnly,
+    Team,       // 只同步给指定队伍的连接, 连接的队伍由容器的队伍解析委托给出
+    Custom,     // 由自定义判定委托决定, 仅C++可用
+};
+
 UENUM(Blueprintable, BlueprintType)
 enum class ENBTSearchCondition : uint8 {
     IfEmpty,
@@ -0,0 +1,94 @@
+﻿#include "NBTCompiledPath.h"
+
+#include "NBTContainer.h"
+
+FNBTCompiledPath FNBTCompiledPath::Compile(const FString& PathString) {
+    FNBTCompiledPath Result;
+    const int32 Len = PathString.Len();
+    int32 Pos = 0;
+
+    while (Pos < Len) {
+        if (PathString[Pos] == TEXT('[')) {
+            const int32 Start = Pos + 1;
+            int32 End = Start;
+            while (End < Len && FChar::IsDigit(PathString[End])) ++End;
+            if (End == Start || End >= Len || PathString[End] != TEXT(']')) {
+                return MakeInvalid(PathString, Pos, TEXT("List index must be a non-negative integer in brackets"));
+            }
+            Result.AppendIndex(FCString::Atoi(*PathString.Mid(Start, End - Start)));
+            Pos = End + 1;
+            continue;
+        }
+
+        if (Result.Num() > 0) { // 非首段的键必须以'.'分隔
+            if (PathString[Pos] != TEXT('.')) {
+                return MakeInvalid(PathString, Pos, TEXT("Expected '.' or '['"));
+            }
+            ++Pos;
+        }
+
+        const int32 Start = Pos;
+        while (Pos < Len && PathString[Pos] != TEXT('.') && PathString[Pos] != TEXT('[') && PathString[Pos] != TEXT(']')) ++Pos;
+        if (Pos == Start) {
+            return MakeInvalid(PathString, Pos, TEXT("Empty key"));
+        }
+        Result.AppendKey(FName(PathString.Mid(Start, Pos - Start)));
+    }
+
+    return Result;
+}
+
+FNBTCompiledPath FNBTCompiledPath::Key(FName InKey) const {
+    FNBTCompiledPath Result;
+    Result.bValid = bValid;
+    Result.Path = Path;
+    Result.Segments.Reserve(Segments.Num() + 1);
+    Result.Segments.Append(Segments);
+    Result.AppendKey(InKey);
+    return Result;
+}
+
+FNBTCompiledPath FNBTCompiledPath::Index(int32 InIndex) const {
+    FNBTCompiledPath Result;
+    Result.bValid = bValid;
+    Result.Path = Path;
+    Result.Segments.Reserve(Segments.Num() + 1);
+    Result.Segments.Append(Segments);
+    Result.AppendIndex(InIndex);
+    return Result;
+}
+
+void FNBTCompiledPath::AppendKey(FName InKey) {
+    Path = Path.Child(InKey);
+    Segments.Emplace(TInPlaceType<FName>(), InKey);
+}
+
+void FNBTCompiledPath::AppendIndex(int32 InIndex) {
+    Path = Path.Child(InIndex);
+    Segments.Emplace(TInPlaceType<int32>(), InIndex);
+}
+
+FNBTDataAccessor FNBTCompiledPath::Resolve(const FNBTContainer& Container) const {
+    return Container.GetAccessor(*this);
+}
+
+FString FNBTCompiledPath::ToString() const {
+    if (!bValid) return TEXT("$Invalid Path$");
+    FString Result;
+    for (const FNBTPathSegment& Segment : Segments) {
+        if (const FName* Name = Segment.TryGet<FName>()) {
+            if (!Result.IsEmpty()) Result += TEXT(".");
+            Result += Name->ToString();
+        } else {
+            Result += FString::Printf(TEXT("[%d]"), Segment.Get<int32>());
+        }
+    }
+    return Result;
+}
+
+FNBTCompiledPath FNBTCompiledPath::MakeInvalid(const FString& PathString, int32 Position, const TCHAR* Reason) {
+    UE_LOG(NBTSystem, Warning, TEXT("FNBTCompiledPath: Failed to compile \"%s\" at %d: %s"), *PathString, Position, Reason);
+    FNBTCompiledPath Result;
+    Result.bValid = false;
+    return Result;
+}
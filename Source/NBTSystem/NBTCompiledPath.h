@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NBTPath.h"
+#include "NBTAccessor.h"
+#include "NBTCompiledPath.generated.h"
+
+// 预编译路径: 字符串只解析一次, FName在编译时驻留, 路径段存放在连续数组中
+// 同一个预编译路径可以在任意容器上解析, 解析结果按容器结构版本缓存在各自容器内
+USTRUCT(BlueprintType)
+struct NBTSYSTEM_API FNBTCompiledPath {
+    GENERATED_BODY()
+
+private:
+    FNBTPath Path;
+
+    TArray<FNBTPathSegment> Segments;
+
+    bool bValid = true;
+
+public:
+    FNBTCompiledPath() = default;
+
+    // 语法: "Stats.Health", "Inventory[3].Name", 空字符串表示根; 语法错误时返回无效路径
+    static FNBTCompiledPath Compile(const FString& PathString);
+
+    // 构建器: 追加一段Map键或List下标
+    FNBTCompiledPath Key(FName InKey) const;
+    FNBTCompiledPath Index(int32 InIndex) const;
+
+    bool IsValid() const { return bValid; }
+
+    int32 Num() const { return Segments.Num(); }
+
+    const TArray<FNBTPathSegment>& GetSegments() const { return Segments; }
+
+    const FNBTPath& GetPath() const { return Path; }
+
+    // 在容器上解析, 等价于 Container.GetAccessor(*this)
+    FNBTDataAccessor Resolve(const FNBTContainer& Container) const;
+
+    FString ToString() const;
+
+    bool operator==(const FNBTCompiledPath& Other) const { return bValid == Other.bValid && Path == Other.Path; }
+
+private:
+    // 原地追加一段, Compile 逐段构建时不再复制已有的段数组
+    void AppendKey(FName InKey);
+    void AppendIndex(int32 InIndex);
+
+    static FNBTCompiledPath MakeInvalid(const FString& PathString, int32 Position, const TCHAR* Reason);
+};
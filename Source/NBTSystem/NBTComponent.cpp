@@ -55,6 +55,8 @@ void UNBTComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorCo
     if (!bOneShotTickRequested)
         return;
 
+    NBTContainer.ForceCommitWriteBatch();
+
     if (GetOwner()->HasAuthority()) {
         if (NBTAccessorRoot.IsSubtreeChangedAndMark()) {
             MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, NBTContainer, this);
@@ -79,7 +81,9 @@ void UNBTComponentLocal::TickComponent(float DeltaTime, ELevelTick TickType, FAc
 
     if (!bOneShotTickRequested)
         return;
-    
+
+    NBTContainer.ForceCommitWriteBatch();
+
     if (NBTAccessorRoot.IsSubtreeChangedAndMark())
         OnNBTContainerChanged.Broadcast();
 
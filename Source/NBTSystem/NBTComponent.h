@@ -7,13 +7,6 @@
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnArzNBTContainerChanged);
 
-UENUM()
-enum class ENBTReplicateCondition : uint8 {
-    All,
-    SkipOwner,
-    OwnerOnly,
-};
-
 UCLASS()
 class NBTSYSTEM_API UNBTComponentBase : public UActorComponent {
     GENERATED_BODY()
@@ -56,6 +49,13 @@ public:
     UFUNCTION(BlueprintCallable)
     int32 GetNodeCount() const { return NBTContainer.GetNodeCount(); }
 
+    // 队伍归属等外部状态变化导致同步条件的判定结果改变时调用, 各连接按新结果增删子树
+    UFUNCTION(BlueprintCallable)
+    void RefreshReplicateFilter() { if (GetOwner() && GetOwner()->HasAuthority()) NBTContainer.InvalidateReplicateFilter(); }
+
+    // Team 条件使用的连接队伍解析
+    void SetConnectionTeamResolver(const FNBTConnectionTeamResolver& Resolver) { NBTContainer.SetConnectionTeamResolver(Resolver); }
+
     virtual void BeginPlay() override;
 
 protected:
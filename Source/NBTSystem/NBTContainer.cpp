@@ -1,7 +1,13 @@
 ﻿#include "NBTContainer.h"
 
 #include "NBTAccessor.h"
+#include "NBTCompiledPath.h"
 #include "NBTComponent.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "GameFramework/Actor.h"
+#include "Serialization/BitReader.h"
 
 FNBTContainer::FNBTContainer() {
     Initialize();
@@ -60,31 +66,33 @@ FNBTAttributeID FNBTContainer::DeepCopyNodeImpl(FNBTAttributeID SourceID, const
     auto* NewAttr = GetAttribute(NewID);
 
     if (SourceAttr->GetType() == ENBTAttributeType::Map) {
-        NewAttr->OverrideToEmptyMap();
+        NewAttr->OverrideToEmptyMap(GetPayloadPool());
         if (auto* SourceMapData = SourceAttr->GetMapData()) {
             if (auto* NewMapData = NewAttr->GetMapData()) {
                 for (auto& KV : SourceMapData->Children) {
                     auto NewChildID = DeepCopyNodeImpl(KV.Value, Source);
                     if (NewChildID.IsValid()) {
                         NewMapData->Children.Emplace(KV.Key, NewChildID);
+                        Allocator.SetNodeParent(NewChildID, NewID);
                     }
                 }
             }
         }
     } else if (SourceAttr->GetType() == ENBTAttributeType::List) {
-        NewAttr->OverrideToEmptyList();
+        NewAttr->OverrideToEmptyList(GetPayloadPool());
         if (auto* SourceListData = SourceAttr->GetListData()) {
             if (auto* NewListData = NewAttr->GetListData()) {
                 for (FNBTAttributeID ChildID : SourceListData->Children) {
                     auto NewChildID = DeepCopyNodeImpl(ChildID, Source);
                     if (NewChildID.IsValid()) {
                         NewListData->Children.Add(NewChildID);
+                        Allocator.SetNodeParent(NewChildID, NewID);
                     }
                 }
             }
         }
     } else {
-        NewAttr->OverrideFromIfNotCompound(*SourceAttr);
+        NewAttr->OverrideFromIfNotCompound(GetPayloadPool(), *SourceAttr);
     }
 
     return NewID;
@@ -94,27 +102,135 @@ void FNBTContainer::Initialize() {
     CreateLiveToken();
     RootID = AllocateNode();
     auto* Root = Allocator.GetAttribute(RootID);
-    Root->OverrideToEmptyMap();
+    Root->OverrideToEmptyMap(GetPayloadPool());
 }
 
 void FNBTContainer::Clear() {
     Allocator.Reset();
     RootID = FNBTAttributeID();
+    Compaction = FCompactionState();
+    CompiledPathMemo.Reset();
+    WriteBatch.PendingSubtreeIDs.Reset();
+    LazySubtree.DirtyIDs.Reset();
+    FieldDelta.Shadows.Reset();
+    ReplicatePolicies.Reset();
 }
 
 void FNBTContainer::Reset() {
     Allocator.Reset();
+    WriteBatch.PendingSubtreeIDs.Reset();
+    LazySubtree.DirtyIDs.Reset();
+    FieldDelta.Shadows.Reset();
+    ReplicatePolicies.Reset();
     RootID = AllocateNode();
     auto* Root = Allocator.GetAttribute(RootID);
-    Root->OverrideToEmptyMap();
+    Root->OverrideToEmptyMap(GetPayloadPool());
     ContainerDataVersion ++;
     ContainerStructVersion ++;
 }
 
+void FNBTContainer::SetUsePayloadArena(bool bUseArena) {
+    GetPayloadPool().SetArenaEnabledOnNextReset(bUseArena);
+}
+
+bool FNBTContainer::IsUsingPayloadArena() const {
+    return GetPayloadPool().IsArenaEnabled();
+}
+
+bool FNBTContainer::CompactIncremental(float TimeBudgetMs) {
+    if (!bShouldOperatorEffectVersion) return true; // 客户端镜像
+    if (IsInWriteBatch()) return false; // 批次中记录的待冒泡节点ID会因搬移失效, 提交批次后再整理
+
+    FlushSubtreeVersions(); // 两次调用之间的延迟写入同样记录了节点ID, 每次搬移前都要先传播
+
+    if (!Compaction.bActive || Compaction.StructVersion != ContainerStructVersion) {
+        Compaction.PendingParents.Reset();
+        Compaction.TargetChunkCount = Allocator.GetMinimalChunkCount();
+        Compaction.SearchHint = 0;
+        if (!RootID.IsValid() || static_cast<int32>(Allocator.GetChunkCount()) <= Compaction.TargetChunkCount) {
+            Allocator.TrimTrailingEmptyChunks();
+            Compaction.bActive = false;
+            return true;
+        }
+        Compaction.PendingParents.Add(RootID);
+        Compaction.StructVersion = ContainerStructVersion;
+        Compaction.bActive = true;
+    }
+
+    const double EndTime = FPlatformTime::Seconds() + TimeBudgetMs / 1000.0;
+    int32 VisitedNum = 0;
+    int32 MovedNum = 0;
+
+    // 子节点在目标块之外则搬移, 并返回是否改写了ID; 父节点可能刚被搬移, 父链接总是重新设置
+    auto RelocateChild = [&](FNBTAttributeID ParentID, FNBTAttributeID& ChildID) -> bool {
+        bool bMoved = false;
+        if (static_cast<int32>(ChildID.Index >> FNBTAllocator::CHUNK_SHIFT) >= Compaction.TargetChunkCount) {
+            const FNBTAttributeID NewID = Allocator.RelocateBelow(ChildID, Compaction.TargetChunkCount, Compaction.SearchHint);
+            if (NewID.IsValid()) {
+                if (ReplicatePolicies.Num() > 0) {
+                    if (TMap<FName, FNBTReplicatePolicy>* Policies = ReplicatePolicies.Find(ChildID)) {
+                        TMap<FName, FNBTReplicatePolicy> MovedPolicies = MoveTemp(*Policies);
+                        ReplicatePolicies.Remove(ChildID);
+                        ReplicatePolicies.Add(NewID, MoveTemp(MovedPolicies));
+                    }
+                }
+                ChildID = NewID;
+                // 被搬移节点的子节点可能要等几帧才轮到处理, 其间从孙节点冒泡不能停在已释放的旧ID上
+                RelinkDirectChildren(NewID);
+                bMoved = true;
+                MovedNum++;
+            }
+        }
+        Allocator.SetNodeParent(ChildID, ParentID);
+        Compaction.PendingParents.Add(ChildID);
+        return bMoved;
+    };
+
+    while (Compaction.PendingParents.Num() > 0) {
+        if ((++VisitedNum & 31) == 0 && FPlatformTime::Seconds() >= EndTime) break;
+
+        const FNBTAttributeID ParentID = Compaction.PendingParents.Pop();
+        FNBTAttribute* Parent = GetAttribute(ParentID);
+        if (!Parent) continue;
+
+        bool bParentChanged = false;
+        if (FNBTMapData* MapData = Parent->GetMapData()) {
+            for (auto& KV : MapData->Children) {
+                bParentChanged |= RelocateChild(ParentID, KV.Value);
+            }
+        } else if (FNBTListData* ListData = Parent->GetListData()) {
+            for (FNBTAttributeID& ChildID : ListData->Children) {
+                bParentChanged |= RelocateChild(ParentID, ChildID);
+            }
+        }
+
+        if (bParentChanged) {
+            UpdateNodeDataVersion(ParentID); // 父节点的子表已改变, 同步时会重新发送
+            UpdateNodeStructVersion(ParentID);
+        }
+    }
+
+    if (MovedNum > 0) {
+        UpdateContainerDataAndStructVersion(); // 使访问器缓存的旧ID失效
+    }
+    Compaction.StructVersion = ContainerStructVersion;
+
+    if (Compaction.PendingParents.Num() > 0) {
+        return false;
+    }
+
+    const int32 TrimmedNum = Allocator.TrimTrailingEmptyChunks();
+    Compaction.bActive = false;
+    UE_LOG(NBTSystem, Verbose, TEXT("NBTContainer: Compaction finished, %d chunks released, %u chunks remain."), TrimmedNum, Allocator.GetChunkCount());
+    return true;
+}
+
 void FNBTContainer::CopyFrom(const FNBTContainer& Other) {
     if (this == &Other) return;
     bShouldOperatorEffectVersion = Other.bShouldOperatorEffectVersion;
     Allocator.Reset();
+    FieldDelta.Shadows.Reset();
+    ReplicatePolicies.Reset(); // 条件按节点ID记录, 拷贝后的节点ID不同, 不随数据拷贝
     RootID = DeepCopyNode(Other.RootID, Other);
     //ContainerDataVersion = Other.ContainerDataVersion;
     //ContainerStructVersion = Other.ContainerStructVersion;
@@ -122,6 +238,139 @@ void FNBTContainer::CopyFrom(const FNBTContainer& Other) {
     ContainerStructVersion ++;
 }
 
+void FNBTContainer::BeginWriteBatch() {
+    if (WriteBatch.Depth++ == 0 && ParentComponent.IsValid()) {
+        ParentComponent->RequestTickNextFrame(); // 帧末检查批次是否已提交
+    }
+}
+
+void FNBTContainer::ForceCommitWriteBatch() {
+    if (WriteBatch.Depth <= 0) return;
+    UE_LOG(NBTSystem, Error, TEXT("NBTContainer: Write batch still open at end of frame (depth %d), force committing. Every BeginWriteBatch must be matched by CommitWriteBatch."), WriteBatch.Depth);
+    WriteBatch.Depth = 1;
+    CommitWriteBatch();
+}
+
+void FNBTContainer::CommitWriteBatch() {
+    if (WriteBatch.Depth <= 0) {
+        UE_LOG(NBTSystem, Warning, TEXT("NBTContainer: CommitWriteBatch called without matching BeginWriteBatch."));
+        return;
+    }
+    if (--WriteBatch.Depth > 0) return;
+
+    for (const FNBTAttributeID& ID : WriteBatch.PendingSubtreeIDs) {
+        IncAttributeSubtreeVersion(ID); // 已释放的节点代数不符, 自动跳过
+    }
+    WriteBatch.PendingSubtreeIDs.Reset();
+
+    if (WriteBatch.bDataChanged) {
+        WriteBatch.bDataChanged = false;
+        UpdateContainerDataVersion();
+    }
+}
+
+void FNBTContainer::BubbleSubtreeVersion(FNBTAttributeID LeafID) {
+    if (LazySubtree.bEnabled) {
+        LazySubtree.DirtyIDs.Add(LeafID);
+        return;
+    }
+    if (WriteBatch.Depth > 0) {
+        for (FNBTAttributeID ID = LeafID; ID.IsValid(); ID = Allocator.GetNodeParent(ID)) {
+            bool bAlreadyPending = false;
+            WriteBatch.PendingSubtreeIDs.Add(ID, &bAlreadyPending);
+            if (bAlreadyPending) break; // 记录时总是连同祖先一起记录
+        }
+        return;
+    }
+    for (FNBTAttributeID ID = LeafID; ID.IsValid(); ID = Allocator.GetNodeParent(ID)) {
+        Allocator.IncNodeSubtreeVersion(ID);
+    }
+}
+
+void FNBTContainer::PropagateLazySubtreeVersions() const {
+    LazySubtree.VisitedIDs.Reset();
+    for (const FNBTAttributeID& LeafID : LazySubtree.DirtyIDs) {
+        for (FNBTAttributeID ID = LeafID; ID.IsValid(); ID = Allocator.GetNodeParent(ID)) {
+            bool bAlreadyVisited = false;
+            LazySubtree.VisitedIDs.Add(ID, &bAlreadyVisited);
+            if (bAlreadyVisited) break; // 更上层的祖先本轮已经自增过
+            Allocator.IncNodeSubtreeVersion(ID); // 已释放的节点父链接为空, 自动停止
+        }
+    }
+    LazySubtree.DirtyIDs.Reset();
+}
+
+void FNBTContainer::SetLazySubtreeVersion(bool bLazy) {
+    if (LazySubtree.bEnabled == bLazy) return;
+    FlushSubtreeVersions();
+    LazySubtree.bEnabled = bLazy;
+}
+
+ENBTAttributeOpResult FNBTContainer::SetReplicatePolicy(FNBTAttributeID MapID, FName Key, const FNBTReplicatePolicy& Policy) {
+    const FNBTAttribute* MapAttr = Allocator.FindLiveAttribute(MapID);
+    if (!MapAttr) return ENBTAttributeOpResult::NotFoundNode;
+    if (!MapAttr->GetMapData()) return ENBTAttributeOpResult::NodeTypeMismatch;
+
+    if (Policy.Condition == ENBTReplicateCondition::All) {
+        TMap<FName, FNBTReplicatePolicy>* Policies = ReplicatePolicies.Find(MapID);
+        if (!Policies || Policies->Remove(Key) == 0) return ENBTAttributeOpResult::SameAndNotChange;
+        if (Policies->Num() == 0) ReplicatePolicies.Remove(MapID);
+    } else {
+        ReplicatePolicies.FindOrAdd(MapID).Add(Key, Policy);
+    }
+
+    // 已连接的客户端需要按新条件增删子树: 推进数据版本并冒泡, 组件随后标记同步
+    UpdateContainerDataVersion();
+    BubbleSubtreeVersion(MapID);
+    return ENBTAttributeOpResult::Success;
+}
+
+const FNBTReplicatePolicy* FNBTContainer::FindReplicatePolicy(FNBTAttributeID MapID, FName Key) const {
+    const TMap<FName, FNBTReplicatePolicy>* Policies = ReplicatePolicies.Find(MapID);
+    return Policies ? Policies->Find(Key) : nullptr;
+}
+
+void FNBTContainer::InvalidateReplicateFilter() {
+    if (ReplicatePolicies.Num() == 0) return;
+    UpdateContainerDataVersion();
+    BubbleSubtreeVersion(RootID);
+}
+
+void FNBTContainer::RelinkDirectChildren(FNBTAttributeID ParentID) const {
+    const FNBTAttribute* Attr = Allocator.FindLiveAttribute(ParentID);
+    if (!Attr) return;
+    if (const FNBTMapData* MapData = Attr->GetMapData()) {
+        for (const auto& KV : MapData->Children) {
+            Allocator.SetNodeParent(KV.Value, ParentID);
+        }
+    } else if (const FNBTListData* ListData = Attr->GetListData()) {
+        for (const FNBTAttributeID& ChildID : ListData->Children) {
+            Allocator.SetNodeParent(ChildID, ParentID);
+        }
+    }
+}
+
+void FNBTContainer::RelinkSubtree(FNBTAttributeID ID) const {
+    TArray<FNBTAttributeID, TInlineAllocator<32>> Pending;
+    Pending.Add(ID);
+    while (Pending.Num() > 0) {
+        const FNBTAttributeID ParentID = Pending.Pop();
+        const FNBTAttribute* Attr = Allocator.FindLiveAttribute(ParentID);
+        if (!Attr) continue;
+        if (const FNBTMapData* MapData = Attr->GetMapData()) {
+            for (const auto& KV : MapData->Children) {
+                Allocator.SetNodeParent(KV.Value, ParentID);
+                Pending.Add(KV.Value);
+            }
+        } else if (const FNBTListData* ListData = Attr->GetListData()) {
+            for (const FNBTAttributeID& ChildID : ListData->Children) {
+                Allocator.SetNodeParent(ChildID, ParentID);
+                Pending.Add(ChildID);
+            }
+        }
+    }
+}
+
 void FNBTContainer::MarkDirtyThisFrame() {
     if (!bDirtyThisFrame) {
         bDirtyThisFrame = true;
@@ -138,6 +387,7 @@ FNBTAttributeID FNBTContainer::AllocateNode() {
 
 int32 FNBTContainer::ReleaseNode(FNBTAttributeID ID) {
     if (!ID.IsValid()) return 0;
+    if (ReplicatePolicies.Num() > 0) ReplicatePolicies.Remove(ID);
     return Allocator.Deallocate(ID) ? 1 : 0;
 }
 
@@ -217,74 +467,23 @@ int32 FNBTContainer::ReleaseChildren(FNBTAttributeID ID) {
 }
 
 void FNBTContainer::UpdateNodeDataVersion(FNBTAttributeID ID) {
-    if (const auto Ptr = GetAttributeVersion(ID); Ptr) {
-        (*Ptr)++;
+    if (Allocator.IsNodeValid(ID)) {
+        Allocator.BumpNodeVersion(ID);
         UpdateContainerDataVersion();
     }
 }
 
-void FNBTContainer::RebuildAllParents() {
-    ParentOf.Reset();
-    RebuildParentsForNode(RootID);
-}
-
-void FNBTContainer::RebuildParentsForNode(FNBTAttributeID ParentID) {
-    if (!ParentID.IsValid()) return;
-    if (auto* Attr = Allocator.GetAttribute(ParentID)) { // 访问当前节点
-        if (auto* MapData = Attr->GetMapData()) {
-            for (const auto& KV : MapData->Children) {
-                ParentOf.FindOrAdd(KV.Value) = ParentID;
-                RebuildParentsForNode(KV.Value);
-            }
-        } else if (auto* ListData = Attr->GetListData()) {
-            for (const auto& ChildID : ListData->Children) {
-                ParentOf.FindOrAdd(ChildID) = ParentID;
-                RebuildParentsForNode(ChildID);
-            }
-        }
-    }
-}
-
-void FNBTContainer::RebuildParentsForDirectChildren(FNBTAttributeID ParentID) {
-    if (!ParentID.IsValid()) return;
-    if (auto* Attr = Allocator.GetAttribute(ParentID)) {
-        // 1) 先收集该父节点“旧记录”的子集合（用来清理已删除的条目）
-        TSet<FNBTAttributeID> OldChildren;
-        for (auto& P : ParentOf) {
-            if (P.Value == ParentID) OldChildren.Add(P.Key);
-        }
-
-        // 2) 按当前数据重建
-        if (auto* MapData = Attr->GetMapData()) {
-            for (const auto& KV : MapData->Children) {
-                ParentOf.FindOrAdd(KV.Value) = ParentID;
-                OldChildren.Remove(KV.Value);
-            }
-        } else if (auto* ListData = Attr->GetListData()) {
-            for (const auto& ChildID : ListData->Children) {
-                ParentOf.FindOrAdd(ChildID) = ParentID;
-                OldChildren.Remove(ChildID);
-            }
-        }
-
-        // 3) 清理不再存在的旧子
-        for (auto& Gone : OldChildren) ParentOf.Remove(Gone);
-    }
-}
-
 void FNBTContainer::BubbleSubtreeVersionAlongPathForID(FNBTAttributeID LeafID) {
     if (!FrameBubbleUniqueKey.Contains(LeafID)) {
         Allocator.IncNodeSubtreeVersion(LeafID);
         FrameBubbleUniqueKey.Add(LeafID);
     }
 
-    FNBTAttributeID Cur = LeafID;
-    while (FNBTAttributeID* P = ParentOf.Find(Cur)) {
-        if (!FrameBubbleUniqueKey.Contains(*P)) {
-            Allocator.IncNodeSubtreeVersion(*P);
-            FrameBubbleUniqueKey.Add(*P);
-        }
-        Cur = *P;
+    for (FNBTAttributeID Cur = Allocator.GetNodeParent(LeafID); Cur.IsValid(); Cur = Allocator.GetNodeParent(Cur)) {
+        bool bAlreadyBubbled = false;
+        FrameBubbleUniqueKey.Add(Cur, &bAlreadyBubbled);
+        if (bAlreadyBubbled) break; // 更上层的祖先在本帧已经自增过
+        Allocator.IncNodeSubtreeVersion(Cur);
     }
     if (!FrameBubbleUniqueKey.Contains(RootID)) {
         Allocator.IncNodeSubtreeVersion(RootID);
@@ -299,6 +498,70 @@ FNBTDataAccessor FNBTContainer::GetAccessor() const {
     return Data;
 }
 
+FNBTDataAccessor FNBTContainer::GetAccessor(const FNBTCompiledPath& CompiledPath) const {
+    if (!CompiledPath.IsValid()) return FNBTDataAccessor();
+
+    FNBTDataAccessor Data = FNBTDataAccessor(const_cast<FNBTContainer*>(this), LiveToken.ToWeakPtr());
+    Data.Path = CompiledPath.GetPath();
+
+    const FNBTAttributeID ID = ResolveCompiledPathID(CompiledPath);
+    if (ID.IsValid()) {
+        Data.CachedAttributeID = ID;
+        Data.CachedContainerStructVersion = ContainerStructVersion;
+    }
+    return Data;
+}
+
+FNBTAttributeID FNBTContainer::ResolveCompiledPathID(const FNBTCompiledPath& CompiledPath) const {
+    if (!RootID.IsValid()) return FNBTAttributeID();
+    if (CompiledPath.Num() == 0) return RootID;
+
+    const FNBTPathNode* PathNode = CompiledPath.GetPath().GetNode();
+    FCompiledPathMemo* MemoPtr = CompiledPathMemo.Find(PathNode);
+    if (MemoPtr && MemoPtr->StructVersion == ContainerStructVersion) {
+        return MemoPtr->ID;
+    }
+    if (!MemoPtr) {
+        if (CompiledPathMemo.Num() >= MAX_COMPILED_PATH_MEMO) {
+            for (auto It = CompiledPathMemo.CreateIterator(); It; ++It) {
+                if (It.Value().StructVersion != ContainerStructVersion) It.RemoveCurrent();
+            }
+            if (CompiledPathMemo.Num() >= MAX_COMPILED_PATH_MEMO) CompiledPathMemo.Reset();
+        }
+        MemoPtr = &CompiledPathMemo.Add(PathNode);
+    }
+    FCompiledPathMemo& Memo = *MemoPtr;
+
+    FNBTAttributeID CurrentID = RootID;
+    for (const FNBTPathSegment& Segment : CompiledPath.GetSegments()) {
+        const FNBTAttribute* Attr = GetAttribute(CurrentID);
+        const FNBTAttributeID* ChildID = nullptr;
+        if (Attr) {
+            if (const FName* Key = Segment.TryGet<FName>()) {
+                if (const FNBTMapData* MapData = Attr->GetMapData()) {
+                    ChildID = MapData->Children.Find(*Key);
+                }
+            } else if (const FNBTListData* ListData = Attr->GetListData()) {
+                const int32 Index = Segment.Get<int32>();
+                if (ListData->Children.IsValidIndex(Index)) {
+                    ChildID = &ListData->Children[Index];
+                }
+            }
+        }
+
+        if (!ChildID) {
+            CurrentID = FNBTAttributeID();
+            break;
+        }
+        CurrentID = *ChildID;
+    }
+
+    Memo.Path = CompiledPath.GetPath();
+    Memo.ID = CurrentID;
+    Memo.StructVersion = ContainerStructVersion;
+    return CurrentID;
+}
+
 FString FNBTContainer::ToString() const {
     FString Result;
 
@@ -308,6 +571,8 @@ FString FNBTContainer::ToString() const {
     Result += FString::Printf(TEXT("Struct Version: %d\n"), ContainerStructVersion);
     Result += FString::Printf(TEXT("Node Count: %d\n"), GetNodeCount());
     Result += FString::Printf(TEXT("Memory Usage: %llu bytes\n"), Allocator.GetMemoryUsage());
+    Result += FString::Printf(TEXT("Payload Pool: %u live, %u cached, %u/%u reused\n"), GetPayloadPool().GetLiveBlocks(),
+        GetPayloadPool().GetCachedBlocks(), GetPayloadPool().GetReusedRequests(), GetPayloadPool().GetTotalRequests());
     Result += FString::Printf(TEXT("Op Effect Version: %s\n"), bShouldOperatorEffectVersion ?
        TEXT("True") : TEXT("False"));
     Result += FString::Printf(TEXT("===================\n"));
@@ -345,6 +610,15 @@ FString FNBTContainer::ToDebugString() const {
     Result += FString::Printf(TEXT("Chunk Count: %u\n"), Allocator.GetChunkCount());
     Result += FString::Printf(TEXT("Free Remaining: %u\n"), Allocator.GetFreeRemaining());
     Result += FString::Printf(TEXT("Memory Usage: %llu bytes\n"), Allocator.GetMemoryUsage());
+    Result += FString::Printf(TEXT("Payload Pool: %u live, %u cached, %u/%u reused\n"), GetPayloadPool().GetLiveBlocks(),
+        GetPayloadPool().GetCachedBlocks(), GetPayloadPool().GetReusedRequests(), GetPayloadPool().GetTotalRequests());
+    Result += FString::Printf(TEXT("Payload Arena: %s (pending %s), %llu bytes, %u releases\n"),
+        GetPayloadPool().IsArenaEnabled() ? TEXT("On") : TEXT("Off"), GetPayloadPool().IsArenaPending() ? TEXT("On") : TEXT("Off"),
+        static_cast<uint64>(GetPayloadPool().GetArenaBytes()), GetPayloadPool().GetArenaReleases());
+    const FNBTChunkPoolStats ChunkPoolStats = FNBTChunkPool::Get().GetStats();
+    Result += FString::Printf(TEXT("Chunk Pool: %d cached (peak %d, limit %d), %llu hits, %llu misses, %llu discards\n"),
+        ChunkPoolStats.CachedChunks, ChunkPoolStats.PeakCachedChunks, FNBTChunkPool::Get().GetHighWaterMark(),
+        ChunkPoolStats.Hits, ChunkPoolStats.Misses, ChunkPoolStats.Discards);
     Result += FString::Printf(TEXT("================================\n\n"));
 
     // 内容
@@ -428,6 +702,18 @@ FArzNBTContainerStats FNBTContainer::GetStatistics() const {
         int32 CurrentDepth = 0;
         GetNodeStatisticsRecursive(RootID, Stats, CurrentDepth);
     }
+    Stats.DeltaCacheHits = DeltaCache.Stats.Hits;
+    Stats.DeltaCacheMisses = DeltaCache.Stats.Misses;
+    Stats.DeltaCacheEvictions = DeltaCache.Stats.Evictions;
+    Stats.DeltaCacheBytes = static_cast<int32>(DeltaCache.TotalBytes);
+    Stats.FieldDeltaPatches = FieldDelta.Stats.Patches;
+    Stats.FieldDeltaFullValues = FieldDelta.Stats.FullValues;
+    Stats.FieldDeltaBytesSaved = static_cast<int64>(FieldDelta.Stats.BytesSaved);
+    SIZE_T ShadowBytes = FieldDelta.Shadows.GetAllocatedSize();
+    for (const TPair<FNBTAttributeID, FNBTFieldShadow>& Pair : FieldDelta.Shadows) {
+        ShadowBytes += Pair.Value.GetAllocatedSize();
+    }
+    Stats.FieldShadowBytes = static_cast<int32>(ShadowBytes);
     return Stats;
 }
 
@@ -488,7 +774,7 @@ bool FNBTContainer::SerializeData(FArchive& Ar, bool NetWorkMode) {
             
             FNBTAttribute* NewAttr = Allocator.AllocateAt(NodeID);
             if (NewAttr) {
-                NewAttr->SerializeNBTData(Ar, NetWorkMode);
+                NewAttr->SerializeNBTData(Ar, NetWorkMode, GetPayloadPool());
             } else {
                 UE_LOG(NBTSystem, Error, TEXT("FNBTContainer::SerializeData: Failed to allocate attribute at ID %s during loading. Archive may be corrupt."),
                        *NodeID.ToString());
@@ -497,18 +783,354 @@ bool FNBTContainer::SerializeData(FArchive& Ar, bool NetWorkMode) {
             }
         }
 
+        RelinkSubtree(RootID); // 父链接不参与序列化, 按子表重建
+
         // 从磁盘上加载之后默认记录变更, 但是网络同步不允许
         if (!NetWorkMode) UpdateContainerDataAndStructVersion();
     } else {
         Allocator.ForEachAttribute([&](FNBTAttributeID NodeID, FNBTAttribute& Attr) {
             Ar << NodeID;
-            Attr.SerializeNBTData(Ar, NetWorkMode);
+            Attr.SerializeNBTData(Ar, NetWorkMode, GetPayloadPool());
         });
     }
     
     return true;
 }
 
+void FNBTContainer::WriteFullSync(FBitWriter& Writer, const FReplicateFilter& Filter) {
+    if (Filter.NumHidden == 0) {
+        SerializeData(Writer, true);
+        return;
+    }
+
+    Writer << bIsContainerReplicated;
+    Writer << ContainerDataVersion;
+    Writer << ContainerStructVersion;
+    Writer << RootID;
+
+    uint32 ActiveNodeCount = Allocator.GetCurrentActive() - Filter.NumHidden;
+    Writer << ActiveNodeCount;
+    Allocator.ForEachAttribute([&](FNBTAttributeID NodeID, FNBTAttribute& Attr) {
+        if (Filter.IsHidden(NodeID)) return;
+        Writer << NodeID;
+        SerializeNodeForNet(Writer, NodeID, Attr, Filter);
+    });
+}
+
+void FNBTContainer::SerializeNodeForNet(FArchive& Ar, FNBTAttributeID ID, FNBTAttribute& Attr, const FReplicateFilter& Filter) {
+    const TArray<FName>* HiddenKeys = Filter.HiddenKeys.Find(ID);
+    const FNBTMapData* MapData = HiddenKeys ? Attr.GetMapData() : nullptr;
+    if (!MapData) {
+        Attr.SerializeNBTData(Ar, true, GetPayloadPool());
+        return;
+    }
+
+    // 与 FNBTAttribute::SerializeNBTData 相同的格式, 只是去掉了被隐藏的键
+    FNBTMapData VisibleData;
+    VisibleData.Children.Reserve(MapData->Children.Num());
+    for (const auto& KV : MapData->Children) {
+        if (!HiddenKeys->Contains(KV.Key)) VisibleData.Children.Emplace(KV.Key, KV.Value);
+    }
+    uint8 TypeIndex = static_cast<uint8>(ENBTAttributeType::Map);
+    Ar << TypeIndex;
+    VisibleData.SerializeNBTData(Ar, true);
+}
+
+const FNBTContainer::FReplicateFilter& FNBTContainer::GetReplicateFilter(const FNetDeltaSerializeInfo& DeltaParms) {
+    static const FReplicateFilter EmptyFilter;
+    if (ReplicatePolicies.Num() == 0) return EmptyFilter;
+
+    FNBTReplicateViewer Viewer;
+    if (UPackageMapClient* PackageMap = Cast<UPackageMapClient>(DeltaParms.Map)) {
+        Viewer.Connection = PackageMap->GetConnection();
+    }
+    if (Viewer.Connection) {
+        const AActor* Owner = ParentComponent.IsValid() ? ParentComponent->GetOwner() : nullptr;
+        const UNetConnection* OwnerConnection = Owner ? Owner->GetNetConnection() : nullptr;
+        if (const UChildConnection* ChildConnection = Cast<UChildConnection>(OwnerConnection)) {
+            OwnerConnection = ChildConnection->Parent; // 分屏玩家的子连接经由父连接同步
+        }
+        Viewer.bIsOwner = OwnerConnection == Viewer.Connection;
+        if (ConnectionTeamResolver.IsBound()) {
+            Viewer.TeamID = ConnectionTeamResolver.Execute(Viewer.Connection);
+        }
+    }
+
+    // 先对所有条件求值; 内容不变时过滤结果只取决于被拒绝的键集合
+    TArray<TPair<FNBTAttributeID, FName>> DeniedKeys;
+    for (const auto& MapPair : ReplicatePolicies) {
+        for (const auto& KeyPair : MapPair.Value) {
+            if (!KeyPair.Value.IsRelevantTo(Viewer)) DeniedKeys.Emplace(MapPair.Key, KeyPair.Key);
+        }
+    }
+    if (DeniedKeys.Num() == 0) return EmptyFilter; // 全部可见时与没有条件完全等价
+
+    // 排序后集合相同的连接得到相同的列表, 与条件表的遍历顺序无关
+    DeniedKeys.Sort([](const TPair<FNBTAttributeID, FName>& A, const TPair<FNBTAttributeID, FName>& B) {
+        if (A.Key.Index != B.Key.Index) return A.Key.Index < B.Key.Index;
+        if (A.Key.Generation != B.Key.Generation) return A.Key.Generation < B.Key.Generation;
+        return A.Value.FastLess(B.Value);
+    });
+    uint32 Signature = 0x9E3779B9; // 与没有任何条件时的签名0区分
+    for (const TPair<FNBTAttributeID, FName>& Denied : DeniedKeys) {
+        Signature = HashCombine(Signature, HashCombine(GetTypeHash(Denied.Key), GetTypeHash(Denied.Value)));
+    }
+
+    ValidateDeltaCache();
+    for (auto It = FilterCache.CreateKeyIterator(Signature); It; ++It) {
+        if (*It.Value().Key.DeniedKeys == DeniedKeys) {
+            return It.Value();
+        }
+    }
+
+    FReplicateFilter& Filter = FilterCache.Add(Signature);
+    Filter.Key.Signature = Signature;
+    Filter.Key.DeniedKeys = MakeShared<const TArray<TPair<FNBTAttributeID, FName>>>(MoveTemp(DeniedKeys));
+    for (const TPair<FNBTAttributeID, FName>& Denied : *Filter.Key.DeniedKeys) {
+        const FNBTAttribute* MapAttr = Allocator.FindLiveAttribute(Denied.Key);
+        const FNBTMapData* MapData = MapAttr ? MapAttr->GetMapData() : nullptr;
+        const FNBTAttributeID* ChildID = MapData ? MapData->Children.Find(Denied.Value) : nullptr;
+        if (!ChildID) continue;
+        Filter.HiddenKeys.FindOrAdd(Denied.Key).Add(Denied.Value);
+        HideSubtree(*ChildID, Filter);
+    }
+    return Filter;
+}
+
+void FNBTContainer::HideSubtree(FNBTAttributeID ID, FReplicateFilter& Filter) const {
+    const FNBTAttribute* Attr = Allocator.FindLiveAttribute(ID);
+    if (!Attr) return;
+
+    uint64& Mask = Filter.HiddenMasks.FindOrAdd(ID.Index >> FNBTAllocator::CHUNK_SHIFT);
+    const uint64 Bit = 1ULL << (ID.Index & FNBTAllocator::CHUNK_MASK);
+    if (Mask & Bit) return; // 嵌套的条件可能重复隐藏同一子树
+    Mask |= Bit;
+    Filter.NumHidden++;
+
+    if (const FNBTMapData* MapData = Attr->GetMapData()) {
+        for (const auto& KV : MapData->Children) {
+            HideSubtree(KV.Value, Filter);
+        }
+    } else if (const FNBTListData* ListData = Attr->GetListData()) {
+        for (const FNBTAttributeID& ChildID : ListData->Children) {
+            HideSubtree(ChildID, Filter);
+        }
+    }
+}
+
+void FNBTContainer::WriteDelta(FBitWriter& Writer, const FArzNBTContainerBaseState& OldState, const FReplicateFilter& Filter) {
+    Writer.WriteBit(false);
+    Writer << ContainerDataVersion;
+    Writer << ContainerStructVersion;
+    const int32 NumChunksMain = Allocator.GetChunkCount();
+    const int32 NumChunksState = OldState.VersionChunks.Num();
+
+    const int32 MaxChunks = FMath::Max(NumChunksMain, NumChunksState);
+
+    TArray<FNBTAttributeID> Added;
+    TArray<FNBTAttributeID> Modified;
+
+    // 同步条件的判定结果变化时, 未变更的块中也可能有节点变为可见或隐藏
+    const bool bFilterChanged = OldState.FilterKey != Filter.Key;
+
+    for (int32 ChunkIdx = 0; ChunkIdx < MaxChunks; ++ChunkIdx) {
+        // 快照之后没有变更过的块直接跳过, 只读连续的变更戳, 不触碰元数据; 快照中不存在的块总是视为已变更
+        if (!bFilterChanged && ChunkIdx < NumChunksState && !Allocator.IsChunkChangedSince(ChunkIdx, OldState.ChangeClock)) {
+            continue;
+        }
+        const FNBTAttributeChunkMetaData* MainChunkMeta = Allocator.GetChunkMetadata(ChunkIdx);
+        const FNBTChunkVersionSnapshot* StateChunkMeta = OldState.GetChunkSnapshot(ChunkIdx);
+        const uint64 MainMask = MainChunkMeta ? MainChunkMeta->UsedMask & ~Filter.GetHiddenMask(ChunkIdx) : 0;
+        const uint64 StateMask = StateChunkMeta ? StateChunkMeta->UsedMask : 0;
+
+        if (MainMask == 0 && StateMask == 0) {
+            continue;
+        }
+        // 找出所有需要检测的Slot
+        
+        uint64 CombinedMask = MainMask | StateMask;
+        while (CombinedMask) {
+            const uint32 LocalIndex = FMath::CountTrailingZeros64(CombinedMask);
+            const uint64 CurrentBit = (1ULL << LocalIndex);
+            const bool bIsInMain = (MainMask & CurrentBit) != 0;
+            const bool bIsInState = (StateMask & CurrentBit) != 0;
+            const FNBTAttributeID::IndexType GlobalIndex = static_cast<FNBTAttributeID::IndexType>((ChunkIdx << FNBTAllocator::CHUNK_SHIFT) | LocalIndex);
+            if (bIsInMain && !bIsInState) { // add
+                FNBTAttributeID CurrentID(GlobalIndex, MainChunkMeta->Generations[LocalIndex]);
+                Added.Add(CurrentID);
+            } else if (!bIsInMain && bIsInState) {  // remove
+                FNBTAttributeID OldID(GlobalIndex, StateChunkMeta->Generations[LocalIndex]);
+                if (!Allocator.FindLiveAttribute(OldID)) FieldDelta.Shadows.Remove(OldID); // 仅对该连接隐藏的节点保留影子
+                uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Remove);
+                Writer << Op;
+                Writer << OldID;
+            } else if (bIsInMain && bIsInState) {// modified
+                if (MainChunkMeta->Versions[LocalIndex] != StateChunkMeta->Versions[LocalIndex] ||
+                    MainChunkMeta->Generations[LocalIndex] != StateChunkMeta->Generations[LocalIndex]) {
+                    FNBTAttributeID CurrentID(GlobalIndex, MainChunkMeta->Generations[LocalIndex]);
+                    Modified.Add(CurrentID);
+                }
+            }
+            
+            CombinedMask &= ~CurrentBit; // 移除当前bit(Index)
+        }
+    }
+
+    // 带条件的Map在判定结果变化后按新的可见键重新发送
+    if (bFilterChanged) {
+        for (const auto& Pair : ReplicatePolicies) {
+            if (Allocator.FindLiveAttribute(Pair.Key) && !Filter.IsHidden(Pair.Key) && OldState.GetVersionForID(Pair.Key)) {
+                Modified.AddUnique(Pair.Key);
+            }
+        }
+    }
+
+    for (FNBTAttributeID& CurrentID : Added) {
+        if (FNBTAttribute* Attr = Allocator.GetAttribute(CurrentID)) {
+            uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Add);
+            Writer << Op;
+            Writer << CurrentID;
+            SerializeNodeForNet(Writer, CurrentID, *Attr, Filter);
+        }
+    }
+
+    for (FNBTAttributeID& CurrentID : Modified) {
+        if (FNBTAttribute* Attr = Allocator.GetAttribute(CurrentID)) {
+            // 带条件的Map在各连接上的内容不同, 与影子比较没有意义
+            if (FNBTFieldDelta::IsPatchCandidate(*Attr) && !ReplicatePolicies.Contains(CurrentID)) {
+                WriteFieldUpdate(Writer, OldState, CurrentID, *Attr);
+                continue;
+            }
+            uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Update);
+            Writer << Op;
+            Writer << CurrentID;
+            SerializeNodeForNet(Writer, CurrentID, *Attr, Filter);
+        }
+    }
+    
+    uint8 EndOp = static_cast<uint8>(EArzNBTDeltaOp::EndOfDeltas);
+    Writer << EndOp;
+}
+
+void FNBTContainer::WriteFieldUpdate(FBitWriter& Writer, const FArzNBTContainerBaseState& OldState, FNBTAttributeID ID, FNBTAttribute& Attr) {
+    // 名字需要按网络方式序列化, 临时写入器与目标写入器保持相同的网络版本
+    FNetBitWriter FullWriter(nullptr, 0);
+    FullWriter.SetEngineNetVer(Writer.EngineNetVer());
+    FullWriter.SetGameNetVer(Writer.GameNetVer());
+    Attr.SerializeNBTData(FullWriter, true, GetPayloadPool());
+
+    FNetBitWriter PatchWriter(nullptr, 0);
+    PatchWriter.SetEngineNetVer(Writer.EngineNetVer());
+    PatchWriter.SetGameNetVer(Writer.GameNetVer());
+    bool bHasPatch = false;
+    FNBTFieldShadow* Shadow = FieldDelta.Shadows.Find(ID);
+    const int32* BaseVersion = OldState.GetVersionForID(ID);
+    if (Shadow && BaseVersion && *BaseVersion == Shadow->Version) {
+        bHasPatch = FNBTFieldDelta::WritePatch(PatchWriter, *Shadow, Attr);
+    }
+
+    uint32 PatchBits = static_cast<uint32>(PatchWriter.GetNumBits());
+    const int64 PatchTotalBits = PatchWriter.GetNumBits() + 40; // 补丁长度按压缩整数的最大长度计入
+    if (bHasPatch && PatchTotalBits < FullWriter.GetNumBits()) {
+        uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Patch);
+        Writer << Op;
+        Writer << ID;
+        Writer.SerializeIntPacked(PatchBits);
+        Writer.SerializeBits(PatchWriter.GetData(), PatchBits);
+        FieldDelta.Stats.Patches++;
+        FieldDelta.Stats.BytesSaved += (FullWriter.GetNumBits() - PatchTotalBits) >> 3;
+    } else {
+        uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Update);
+        Writer << Op;
+        Writer << ID;
+        Writer.SerializeBits(FullWriter.GetData(), FullWriter.GetNumBits());
+        FieldDelta.Stats.FullValues++;
+    }
+
+    // 其他连接的基线若仍是旧版本, 之后只能收到完整值; 基线相同的连接通常直接命中差分缓存
+    const int32* CurrentVersion = Allocator.FindLiveVersion(ID);
+    if (!CurrentVersion) return;
+    if (!Shadow) {
+        Shadow = &FieldDelta.Shadows.Add(ID);
+    } else if (Shadow->Version == *CurrentVersion && Shadow->Type == Attr.GetType()) {
+        return;
+    }
+    FNBTFieldDelta::CaptureShadow(Attr, *CurrentVersion, *Shadow);
+}
+
+FNBTChunkVersionSnapshotRef FNBTContainer::AcquireChunkSnapshot(int32 ChunkIndex) const {
+    const FNBTAttributeChunkMetaData* Meta = Allocator.GetChunkMetadata(ChunkIndex);
+    if (!Meta || Meta->UsedMask == 0) return nullptr; // 空块与不存在的块在差分中等价
+
+    const int32 NumChunks = Allocator.GetChunkCount();
+    if (ChunkSnapshots.Num() != NumChunks) {
+        ChunkSnapshots.SetNum(NumChunks); // 尾部块被裁剪后对应快照一并释放, 重建的块变更戳必然更新
+    }
+
+    FChunkSnapshotSlot& Slot = ChunkSnapshots[ChunkIndex];
+    const uint64 Stamp = Allocator.GetChunkChangeStamp(ChunkIndex);
+    if (!Slot.Snapshot.IsValid() || Slot.ChangeStamp != Stamp) {
+        Slot.Snapshot = MakeShared<FNBTChunkVersionSnapshot>(*Meta);
+        Slot.ChangeStamp = Stamp;
+    }
+    return Slot.Snapshot;
+}
+
+void FNBTContainer::ValidateDeltaCache() {
+    // 容器内容任何变化都会推进变更时钟或版本号, 此时所有缓存的差分都已过期
+    const uint64 Clock = Allocator.GetChangeClock();
+    if (DeltaCache.ContentClock == Clock &&
+        DeltaCache.ContentDataVersion == ContainerDataVersion &&
+        DeltaCache.ContentStructVersion == ContainerStructVersion) {
+        return;
+    }
+    DeltaCache.Entries.Reset();
+    DeltaCache.TotalBytes = 0;
+    FilterCache.Reset();
+    DeltaCache.ContentClock = Clock;
+    DeltaCache.ContentDataVersion = ContainerDataVersion;
+    DeltaCache.ContentStructVersion = ContainerStructVersion;
+}
+
+bool FNBTContainer::ReplayCachedDelta(FBitWriter& Writer, uint64 BaselineClock, int32 BaselineVersion, const FReplicateFilterKey& BaselineFilter, const FReplicateFilterKey& FilterKey) {
+    ValidateDeltaCache();
+    for (const FDeltaCacheEntry& Entry : DeltaCache.Entries) {
+        if (Entry.BaselineClock == BaselineClock && Entry.BaselineVersion == BaselineVersion &&
+            Entry.BaselineFilter == BaselineFilter && Entry.Filter == FilterKey) {
+            Writer.SerializeBits(const_cast<uint8*>(Entry.Data.GetData()), Entry.NumBits);
+            DeltaCache.Stats.Hits++;
+            return true;
+        }
+    }
+    DeltaCache.Stats.Misses++;
+    return false;
+}
+
+void FNBTContainer::StoreCachedDelta(FBitWriter& Writer, int64 StartBits, uint64 BaselineClock, int32 BaselineVersion, const FReplicateFilterKey& BaselineFilter, const FReplicateFilterKey& FilterKey) {
+    if (Writer.IsError()) return;
+    const int64 NumBits = Writer.GetNumBits() - StartBits;
+    const int64 NumBytes = FMath::DivideAndRoundUp<int64>(NumBits, 8);
+    if (NumBits <= 0 || NumBytes > FDeltaPayloadCache::MAX_ENTRY_BYTES) return; // 超大的全量数据不缓存
+
+    // 先进先出淘汰, 同一内容版本下不同基线的数量通常很少
+    while (DeltaCache.Entries.Num() > 0 &&
+           (DeltaCache.Entries.Num() >= FDeltaPayloadCache::MAX_ENTRIES || DeltaCache.TotalBytes + NumBytes > FDeltaPayloadCache::MAX_TOTAL_BYTES)) {
+        DeltaCache.TotalBytes -= DeltaCache.Entries[0].Data.Num();
+        DeltaCache.Entries.RemoveAt(0);
+        DeltaCache.Stats.Evictions++;
+    }
+
+    FDeltaCacheEntry& Entry = DeltaCache.Entries.AddDefaulted_GetRef();
+    Entry.BaselineClock = BaselineClock;
+    Entry.BaselineVersion = BaselineVersion;
+    Entry.BaselineFilter = BaselineFilter;
+    Entry.Filter = FilterKey;
+    Entry.NumBits = NumBits;
+    Entry.Data.SetNumZeroed(NumBytes);
+    appBitsCpy(Entry.Data.GetData(), 0, Writer.GetData(), StartBits, NumBits);
+    DeltaCache.TotalBytes += NumBytes;
+}
+
 bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
     if (DeltaParms.bUpdateUnmappedObjects) {
         return true;
@@ -521,6 +1143,8 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
       
         FBitWriter& Writer = *DeltaParms.Writer;
         FArzNBTContainerBaseState* OldState = static_cast<FArzNBTContainerBaseState*>(DeltaParms.OldState);
+        // 该连接可见的子集, 没有同步条件时为空过滤
+        const FReplicateFilter& Filter = GetReplicateFilter(DeltaParms);
         // 全量同步
         if (OldState == nullptr) {
             
@@ -529,17 +1153,21 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
             }
             
             bIsContainerReplicated = true;
-            
-            Writer.WriteBit(true);
-            SerializeData(Writer, true);
+
+            if (!ReplayCachedDelta(Writer, FULL_SYNC_BASELINE_CLOCK, INDEX_NONE, FReplicateFilterKey(), Filter.Key)) {
+                const int64 StartBits = Writer.GetNumBits();
+                Writer.WriteBit(true);
+                WriteFullSync(Writer, Filter);
+                StoreCachedDelta(Writer, StartBits, FULL_SYNC_BASELINE_CLOCK, INDEX_NONE, FReplicateFilterKey(), Filter.Key);
+            }
             TSharedPtr<FArzNBTContainerBaseState> NewState = MakeShared<FArzNBTContainerBaseState>();
-            NewState->CreateVersionSnapshotFromContainer(*this);
+            NewState->CreateVersionSnapshotFromContainer(*this, Filter);
             *DeltaParms.NewState = NewState;
             UE_LOG(NBTSystem, Log, TEXT("NBTContainer: Sent initial full sync. Size: %lld bytes"), Writer.GetNumBytes());
             return true;
         }
 
-        if (OldState->ContainerVersion == ContainerDataVersion) { //什么都没改
+        if (OldState->ContainerVersion == ContainerDataVersion && OldState->FilterKey == Filter.Key) { //什么都没改
             return false;
         }
 
@@ -547,83 +1175,15 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
         //DebugRecord += "    " + FString::FromInt(ContainerDataVersion) + "\n";
         //DebugRecord += "    " + FString::FromInt(ContainerStructVersion) + "\n";
         // 增量同步
-        Writer.WriteBit(false);
-        Writer << ContainerDataVersion;
-        Writer << ContainerStructVersion;
-        const int32 NumChunksMain = Allocator.GetChunkCount();
-        const int32 NumChunksState = OldState->VersionChunks.Num();
-
-        const int32 MaxChunks = FMath::Max(NumChunksMain, NumChunksState);
-
-        TArray<FNBTAttributeID> Added;
-        TArray<FNBTAttributeID> Modified;
-
-        for (int32 ChunkIdx = 0; ChunkIdx < MaxChunks; ++ChunkIdx) {
-            const FNBTAttributeChunkMetaData* MainChunkMeta = Allocator.GetChunkMetadata(ChunkIdx);
-            const FNBTAttributeChunkMetaData* StateChunkMeta = OldState->VersionChunks.IsValidIndex(ChunkIdx) ? &OldState->VersionChunks[ChunkIdx] : nullptr;
-
-            // 快速优化: 如果两个块都存在, 并且完全相同, 直接跳过
-            if (MainChunkMeta && StateChunkMeta && FMemory::Memcmp(MainChunkMeta, StateChunkMeta, sizeof(FNBTAttributeChunkMetaData)) == 0) {
-                continue;
-            }
-            const uint64 MainMask = MainChunkMeta ? MainChunkMeta->UsedMask : 0;
-            const uint64 StateMask = StateChunkMeta ? StateChunkMeta->UsedMask : 0;
-
-            if (MainMask == 0 && StateMask == 0) {
-                continue;
-            }
-            // 找出所有需要检测的Slot
-            
-            uint64 CombinedMask = MainMask | StateMask;
-            while (CombinedMask) {
-                const uint32 LocalIndex = FMath::CountTrailingZeros64(CombinedMask);
-                const uint64 CurrentBit = (1ULL << LocalIndex);
-                const bool bIsInMain = (MainMask & CurrentBit) != 0;
-                const bool bIsInState = (StateMask & CurrentBit) != 0;
-                const uint16 GlobalIndex = (ChunkIdx << FNBTAllocator::CHUNK_SHIFT) | LocalIndex;
-                if (bIsInMain && !bIsInState) { // add
-                    FNBTAttributeID CurrentID(GlobalIndex, MainChunkMeta->Generations[LocalIndex]);
-                    Added.Add(CurrentID);
-                } else if (!bIsInMain && bIsInState) {  // remove
-                    FNBTAttributeID OldID(GlobalIndex, StateChunkMeta->Generations[LocalIndex]);
-                    uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Remove);
-                    Writer << Op;
-                    Writer << OldID;
-                } else if (bIsInMain && bIsInState) {// modified
-                    if (MainChunkMeta->Versions[LocalIndex] != StateChunkMeta->Versions[LocalIndex] ||
-                        MainChunkMeta->Generations[LocalIndex] != StateChunkMeta->Generations[LocalIndex]) {
-                        FNBTAttributeID CurrentID(GlobalIndex, MainChunkMeta->Generations[LocalIndex]);
-                        Modified.Add(CurrentID);
-                    }
-                }
-                
-                CombinedMask &= ~CurrentBit; // 移除当前bit(Index)
-            }
-        }
-
-        for (FNBTAttributeID& CurrentID : Added) {
-            if (FNBTAttribute* Attr = Allocator.GetAttribute(CurrentID)) {
-                uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Add);
-                Writer << Op;
-                Writer << CurrentID;
-                Attr->SerializeNBTData(Writer, true);
-            }
-        }
-
-        for (FNBTAttributeID& CurrentID : Modified) {
-            if (FNBTAttribute* Attr = Allocator.GetAttribute(CurrentID)) {
-                uint8 Op = static_cast<uint8>(EArzNBTDeltaOp::Update);
-                Writer << Op;
-                Writer << CurrentID;
-                Attr->SerializeNBTData(Writer, true);
-            }
+        // 基线相同的连接共享同一份序列化结果, 只有第一个连接真正计算差分
+        if (!ReplayCachedDelta(Writer, OldState->ChangeClock, OldState->ContainerVersion, OldState->FilterKey, Filter.Key)) {
+            const int64 StartBits = Writer.GetNumBits();
+            WriteDelta(Writer, *OldState, Filter);
+            StoreCachedDelta(Writer, StartBits, OldState->ChangeClock, OldState->ContainerVersion, OldState->FilterKey, Filter.Key);
         }
-        
-        uint8 EndOp = static_cast<uint8>(EArzNBTDeltaOp::EndOfDeltas);
-        Writer << EndOp;
 
         FArzNBTContainerBaseState* NewState = new FArzNBTContainerBaseState();
-        NewState->CreateVersionSnapshotFromContainer(*this);
+        NewState->CreateVersionSnapshotFromContainer(*this, Filter);
         *DeltaParms.NewState = TSharedPtr<INetDeltaBaseState>(NewState);
         // UE_LOG(NBTSystem, Log, TEXT("NBTContainer: Sent delta sync. Size: %lld bytes"), Writer.GetNumBytes());
         // UE_LOG(NBTSystem, Log, TEXT("%s"), *DebugRecord);
@@ -645,18 +1205,13 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
             // UE_LOG(NBTSystem, Log, TEXT("NBTContainer: Receiving delta sync."));
 
             FrameBubbleUniqueKey.Reset();
-            
-            auto PreContainerStructVersion = ContainerStructVersion;
-            bool Rebuilded = false;
-            
+
+            // 本帧数据改变的节点; 子表可能引用本帧稍后才分配的节点, 全部读完后再修复父链接并冒泡
+            TArray<FNBTAttributeID, TInlineAllocator<16>> TouchedIDs;
+
             Reader << ContainerDataVersion;
             Reader << ContainerStructVersion;
 
-            if (PreContainerStructVersion != ContainerStructVersion) {                                                                                                                                     
-                RebuildAllParents();                                                                                                                                                                       
-                Rebuilded = true;                                                                                                                                                                          
-            } 
-
             while (!Reader.AtEnd() && !Reader.IsError()) {
                 uint8 OpCode;
                 
@@ -668,25 +1223,38 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
                 Reader << ID;
                 
                 if (Op == EArzNBTDeltaOp::Remove) {
-                    BubbleSubtreeVersionAlongPathForID(ID);
+                    TouchedIDs.Add(Allocator.GetNodeParent(ID)); // 释放后父链接随之清除, 先记下
                     ReleaseNode(ID);
-                } else if (Op == EArzNBTDeltaOp::Add) {
-                    if (!Rebuilded && PreContainerStructVersion != ContainerStructVersion) {
-                        RebuildAllParents();
-                        Rebuilded = true;
-                    }
-                    if (FNBTAttribute* Attr = Allocator.AllocateAt(ID)) {
-                        Attr->SerializeNBTData(Reader, true);
-                        BubbleSubtreeVersionAlongPathForID(ID);
-                    } else {
-                        UE_LOG(NBTSystem, Error, TEXT("NBTContainer: Failed to AllocateAt ID %s on client."), *ID.ToString());
+                } else if (Op == EArzNBTDeltaOp::Patch) {
+                    uint32 PatchBits = 0;
+                    Reader.SerializeIntPacked(PatchBits);
+                    if (Reader.IsError() || PatchBits > Reader.GetBitsLeft()) {
+                        UE_LOG(NBTSystem, Error, TEXT("NBTContainer: Invalid field patch size %u for ID %s."), PatchBits, *ID.ToString());
                         Reader.SetError();
                         return false;
                     }
-                } else if (Op == EArzNBTDeltaOp::Update) {
+                    // 补丁整体读出后再应用, 补丁内部的读取不会越过本操作的边界
+                    TArray<uint8> PatchData;
+                    PatchData.SetNumUninitialized((PatchBits + 7) >> 3);
+                    Reader.SerializeBits(PatchData.GetData(), PatchBits);
+                    FNetBitReader PatchReader(nullptr, PatchData.GetData(), PatchBits);
+                    PatchReader.SetEngineNetVer(Reader.EngineNetVer());
+                    PatchReader.SetGameNetVer(Reader.GameNetVer());
+
+                    FNBTAttribute* Attr = Allocator.GetAttribute(ID);
+                    if (Attr && FNBTFieldDelta::ApplyPatch(PatchReader, *Attr)) {
+                        // 与 AllocateSlotAt 的 Hack Op 一致: 补丁可能改变子表(列表拼接/Map重指向), 数据版本与结构版本都要自增
+                        Allocator.BumpNodeVersion(ID);
+                        Allocator.IncNodeStructVersion(ID);
+                        TouchedIDs.Add(ID);
+                    } else {
+                        // 补丁基于尚未确认的基线, 丢包后基准不符属于正常情况; 只跳过本操作, 服务器回退到已确认的基线后会重发完整值
+                        UE_LOG(NBTSystem, Verbose, TEXT("NBTContainer: Skipped field patch for ID %s, base value does not match."), *ID.ToString());
+                    }
+                } else if (Op == EArzNBTDeltaOp::Add || Op == EArzNBTDeltaOp::Update) {
                     if (FNBTAttribute* Attr = Allocator.AllocateAt(ID)) {
-                        Attr->SerializeNBTData(Reader, true);
-                        BubbleSubtreeVersionAlongPathForID(ID);
+                        Attr->SerializeNBTData(Reader, true, GetPayloadPool());
+                        TouchedIDs.Add(ID);
                     } else {
                         UE_LOG(NBTSystem, Error, TEXT("NBTContainer: Failed to AllocateAt ID %s on client."), *ID.ToString());
                         Reader.SetError();
@@ -698,6 +1266,13 @@ bool FNBTContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
                     return false;
                 }
             }
+
+            for (const FNBTAttributeID& ID : TouchedIDs) {
+                RelinkDirectChildren(ID);
+            }
+            for (const FNBTAttributeID& ID : TouchedIDs) {
+                BubbleSubtreeVersionAlongPathForID(ID);
+            }
         }
     }
     return true;
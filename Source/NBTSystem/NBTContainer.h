@@ -4,18 +4,23 @@
 #include "NBTAllocator.h"
 #include "NBTAttribute.h"
 #include "NBTAttributeID.h"
+#include "NBTFieldDelta.h"
+#include "NBTPath.h"
 #include "Engine/NetSerialization.h"
 #include "UObject/Object.h"
 #include "NBTContainer.generated.h"
 
 class UNBTComponentBase;
+class UNetConnection;
 class FArzNBTContainerBaseState;
+struct FNBTCompiledPath;
 
 enum class EArzNBTDeltaOp : uint8 {
     Add,
     Update,
     Remove,
-    EndOfDeltas
+    EndOfDeltas,
+    Patch,      // 字段级补丁, 见 FNBTFieldDelta
 };
 
 USTRUCT(BlueprintType)
@@ -39,10 +44,78 @@ struct FArzNBTContainerStats {
 
     UPROPERTY(VisibleAnywhere)
     TMap<ENBTAttributeType, int32> TypeCounts;
+
+    // 网络差分缓存: 命中表示直接重放了同一基线的序列化结果
+    UPROPERTY(VisibleAnywhere)
+    int32 DeltaCacheHits = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int32 DeltaCacheMisses = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int32 DeltaCacheEvictions = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int32 DeltaCacheBytes = 0;
+
+    // 字段级差分: 以补丁代替完整值发送的次数, 以及因此少发送的字节
+    UPROPERTY(VisibleAnywhere)
+    int32 FieldDeltaPatches = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int32 FieldDeltaFullValues = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int64 FieldDeltaBytesSaved = 0;
+
+    UPROPERTY(VisibleAnywhere)
+    int32 FieldShadowBytes = 0;
 };
 
 DECLARE_DELEGATE(FNBTContainerDeltaCallback);
 
+// 网络基线中单个块的版本快照, 只保留差分需要的字段; 创建后不可修改, 块未变更时被相邻基线与所有连接共享
+struct FNBTChunkVersionSnapshot {
+    uint64 UsedMask = 0;
+    FNBTAttributeID::GenerationType Generations[ARZ_NBT_CHUNK_SIZE] {};
+    int32 Versions[ARZ_NBT_CHUNK_SIZE] {};
+
+    explicit FNBTChunkVersionSnapshot(const FNBTAttributeChunkMetaData& Meta) : UsedMask(Meta.UsedMask) {
+        FMemory::Memcpy(Generations, Meta.Generations, sizeof(Generations));
+        FMemory::Memcpy(Versions, Meta.Versions, sizeof(Versions));
+    }
+};
+
+using FNBTChunkVersionSnapshotRef = TSharedPtr<const FNBTChunkVersionSnapshot>;
+
+// 同步条件的判定对象: 正在为其序列化差分的连接
+struct FNBTReplicateViewer {
+    const UNetConnection* Connection = nullptr;
+    bool bIsOwner = false;      // 连接是否拥有容器所在的Actor
+    int32 TeamID = INDEX_NONE;  // 由容器的队伍解析委托给出, 未设置委托时为INDEX_NONE
+};
+
+DECLARE_DELEGATE_RetVal_OneParam(bool, FNBTReplicatePredicate, const FNBTReplicateViewer&);
+
+DECLARE_DELEGATE_RetVal_OneParam(int32, FNBTConnectionTeamResolver, const UNetConnection*);
+
+// 挂在Map键上的同步条件, 作用于键下的整个子树
+struct FNBTReplicatePolicy {
+    ENBTReplicateCondition Condition = ENBTReplicateCondition::All;
+    int32 TeamID = INDEX_NONE;          // Team: 只同步给该队伍的连接
+    FNBTReplicatePredicate Predicate;   // Custom: 返回true时同步
+
+    bool IsRelevantTo(const FNBTReplicateViewer& Viewer) const {
+        switch (Condition) {
+            case ENBTReplicateCondition::SkipOwner: return !Viewer.bIsOwner;
+            case ENBTReplicateCondition::OwnerOnly: return Viewer.bIsOwner;
+            case ENBTReplicateCondition::Team: return TeamID != INDEX_NONE && Viewer.TeamID == TeamID;
+            case ENBTReplicateCondition::Custom: return Predicate.IsBound() && Predicate.Execute(Viewer);
+            default: return true;
+        }
+    }
+};
+
 USTRUCT(BlueprintType)
 struct FNBTContainer {
     GENERATED_BODY()
@@ -67,16 +140,161 @@ private:
 
     TSharedPtr<uint8> LiveToken;
 
-    TMap<FNBTAttributeID, FNBTAttributeID> ParentOf; // 客户端专用
-
     TSet<FNBTAttributeID> FrameBubbleUniqueKey; // 客户端专用
 
     bool bDirtyThisFrame = false;
 
+    // 增量整理状态, 跨帧保留
+    struct FCompactionState {
+        TArray<FNBTAttributeID> PendingParents; // 待处理的父节点(深度优先)
+        int32 TargetChunkCount = 0;             // 整理目标: 节点全部落在这些块中
+        int32 SearchHint = 0;                   // 目标空洞的搜索起点
+        int32 StructVersion = INDEX_NONE;       // 上次推进后的结构版本, 不一致说明中途有结构修改, 需要重新开始
+        bool bActive = false;
+    } Compaction;
+
+    // 预编译路径的解析缓存, 结构版本不变时直接复用; 持有路径本身以保证键指针有效
+    struct FCompiledPathMemo {
+        FNBTPath Path;
+        FNBTAttributeID ID;
+        int32 StructVersion = INDEX_NONE;
+    };
+
+    mutable TMap<const FNBTPathNode*, FCompiledPathMemo> CompiledPathMemo;
+
+    // 缓存条目上限; 插入新条目时若已满, 先丢弃结构版本过期的条目, 仍然满则整体清空, 不再长期持有解析过的所有路径
+    static constexpr int32 MAX_COMPILED_PATH_MEMO = 1024;
+
+    // 批量写入状态: 期间数据版本自增与子树版本冒泡被推迟到最外层提交
+    struct FWriteBatchState {
+        int32 Depth = 0;
+        bool bDataChanged = false;
+        TSet<FNBTAttributeID> PendingSubtreeIDs; // 待冒泡的节点, 每个只自增一次
+    } WriteBatch;
+
+    // 延迟子树版本: 写入只记录被修改的节点, 读取子树版本前(或帧末)沿父链接统一传播, 每个祖先每轮只自增一次
+    struct FLazySubtreeState {
+        bool bEnabled = false;
+        TSet<FNBTAttributeID> DirtyIDs;     // 上次传播之后被修改的节点
+        TSet<FNBTAttributeID> VisitedIDs;   // 传播时的去重表, 跨轮复用内存
+    };
+
+    mutable FLazySubtreeState LazySubtree;
+
+    // 网络差分缓存: 同一内容版本下, 基线相同的连接共享序列化好的差分比特流; 内容变化后整体作废
+    static constexpr uint64 FULL_SYNC_BASELINE_CLOCK = MAX_uint64; // 全量同步没有基线, 用此值作为键
+
+    // 同步条件对某个连接的判定结果: 被拒绝的 (Map节点ID, 键) 排序后共享; 签名只用于分桶, 相等性按内容比较
+    struct FReplicateFilterKey {
+        uint32 Signature = 0;
+        TSharedPtr<const TArray<TPair<FNBTAttributeID, FName>>> DeniedKeys; // 为空表示没有被拒绝的键
+
+        bool operator==(const FReplicateFilterKey& Other) const {
+            if (Signature != Other.Signature) return false;
+            if (DeniedKeys == Other.DeniedKeys) return true;
+            if (!DeniedKeys.IsValid() || !Other.DeniedKeys.IsValid()) return false;
+            return *DeniedKeys == *Other.DeniedKeys;
+        }
+
+        bool operator!=(const FReplicateFilterKey& Other) const { return !(*this == Other); }
+    };
+
+    struct FDeltaCacheEntry {
+        uint64 BaselineClock = 0;
+        int32 BaselineVersion = INDEX_NONE;
+        FReplicateFilterKey BaselineFilter; // 基线与本次的同步条件判定结果, 见 FReplicateFilter
+        FReplicateFilterKey Filter;
+        int64 NumBits = 0;
+        TArray<uint8> Data;
+    };
+
+    struct FDeltaPayloadCache {
+        static constexpr int32 MAX_ENTRIES = 8;
+        static constexpr int64 MAX_ENTRY_BYTES = 64 * 1024;
+        static constexpr int64 MAX_TOTAL_BYTES = 256 * 1024;
+
+        uint64 ContentClock = MAX_uint64; // 缓存生成时的分配器变更时钟与容器版本
+        int32 ContentDataVersion = INDEX_NONE;
+        int32 ContentStructVersion = INDEX_NONE;
+        TArray<FDeltaCacheEntry, TInlineAllocator<MAX_ENTRIES>> Entries;
+        int64 TotalBytes = 0;
+
+        struct {
+            uint32 Hits = 0;
+            uint32 Misses = 0;
+            uint32 Evictions = 0;
+        } Stats;
+    } DeltaCache;
+
+    // 每个块最近一次生成的版本快照及生成时的块变更戳, 变更戳未推进时新基线直接引用同一份快照
+    struct FChunkSnapshotSlot {
+        uint64 ChangeStamp = 0;
+        FNBTChunkVersionSnapshotRef Snapshot;
+    };
+
+    mutable TArray<FChunkSnapshotSlot> ChunkSnapshots;
+
+    // 字段级差分状态: 大节点最近一次发送的值副本, 节点释放或容器清空时丢弃
+    struct FFieldDeltaState {
+        TMap<FNBTAttributeID, FNBTFieldShadow> Shadows;
+
+        struct {
+            uint32 Patches = 0;
+            uint32 FullValues = 0;
+            uint64 BytesSaved = 0;
+        } Stats;
+    } FieldDelta;
+
+    // 返回块当前内容的共享快照, 只有变更过的块才重新拷贝; 空块返回空指针
+    FNBTChunkVersionSnapshotRef AcquireChunkSnapshot(int32 ChunkIndex) const;
+
+    // 子树同步条件: Map节点ID -> (键 -> 条件); 只在服务器上生效, Map节点释放或搬移时随之移除或改写
+    TMap<FNBTAttributeID, TMap<FName, FNBTReplicatePolicy>> ReplicatePolicies;
+
+    FNBTConnectionTeamResolver ConnectionTeamResolver;
+
+    // 针对一个连接求出的可见子集: 被隐藏的节点按块记录为掩码, 带条件的Map记录被隐藏的键
+    struct FReplicateFilter {
+        FReplicateFilterKey Key; // 内容不变时判定结果相同的连接看到相同的子集
+        int32 NumHidden = 0;
+        TMap<int32, uint64> HiddenMasks;
+        TMap<FNBTAttributeID, TArray<FName>> HiddenKeys;
+
+        uint64 GetHiddenMask(int32 ChunkIndex) const {
+            const uint64* Mask = HiddenMasks.Find(ChunkIndex);
+            return Mask ? *Mask : 0;
+        }
+
+        bool IsHidden(FNBTAttributeID ID) const {
+            return (GetHiddenMask(ID.Index >> FNBTAllocator::CHUNK_SHIFT) & (1ULL << (ID.Index & FNBTAllocator::CHUNK_MASK))) != 0;
+        }
+    };
+
+    // 同一内容版本下按判定结果缓存过滤结果, 只有第一个连接需要遍历被隐藏的子树; 随差分缓存一起作废
+    // 签名只用于分桶, 同一桶内逐个比较被拒绝的键列表
+    TMultiMap<uint32, FReplicateFilter> FilterCache;
+
+    const FReplicateFilter& GetReplicateFilter(const FNetDeltaSerializeInfo& DeltaParms);
+
+    void HideSubtree(FNBTAttributeID ID, FReplicateFilter& Filter) const;
+
+    ENBTAttributeOpResult SetReplicatePolicy(FNBTAttributeID MapID, FName Key, const FNBTReplicatePolicy& Policy);
+
+    const FNBTReplicatePolicy* FindReplicatePolicy(FNBTAttributeID MapID, FName Key) const;
+
     friend struct FNBTDataAccessor;
 
     friend class FArzNBTContainerBaseState;
 
+    friend class FNBTSchemaView;
+
+    template <typename T>
+    friend class TNBTSchemaField;
+
+#if WITH_DEV_AUTOMATION_TESTS
+    friend struct FNBTTestAccess; // 仅测试/基准使用, 见 Tests/NBTTestAccess.h
+#endif
+
     void CreateLiveToken() { LiveToken = MakeShared<uint8>(); }
 
     void MarkDirtyThisFrame();
@@ -85,19 +303,31 @@ private:
 
     void UpdateContainerDataVersion() {
         if (!bShouldOperatorEffectVersion) return;
+        if (WriteBatch.Depth > 0) {
+            WriteBatch.bDataChanged = true;
+            return;
+        }
         ContainerDataVersion++;
         if (!bDirtyThisFrame)
             MarkDirtyThisFrame();
     }
 
+    // 结构版本总是立即自增, 其他访问器的缓存依赖它; 数据版本在批量写入中推迟
     void UpdateContainerDataAndStructVersion() {
         if (!bShouldOperatorEffectVersion) return;
-        ContainerDataVersion++;
         ContainerStructVersion++;
-        if (!bDirtyThisFrame)
-            MarkDirtyThisFrame();
+        UpdateContainerDataVersion();
     }
 
+    // 子树版本冒泡: 从节点自身沿父链接走到根; 批量写入中只记录, 提交时统一自增; 延迟模式下只记录节点本身
+    void BubbleSubtreeVersion(FNBTAttributeID LeafID);
+
+    void PropagateLazySubtreeVersions() const;
+
+    // 父链接维护: 子表被整体替换(反序列化/网络同步)后按当前子表重新设置
+    void RelinkDirectChildren(FNBTAttributeID ParentID) const;
+    void RelinkSubtree(FNBTAttributeID ID) const;
+
     FNBTAttributeID AllocateNode();
 
     void Initialize();
@@ -113,10 +343,10 @@ private:
 
     void UpdateNodeDataVersion(FNBTAttributeID ID);
 
-    void RebuildAllParents();
-    void RebuildParentsForNode(FNBTAttributeID ParentID);
-    void RebuildParentsForDirectChildren(FNBTAttributeID ParentID);
-    void BubbleSubtreeVersionAlongPathForID(FNBTAttributeID LeafID);
+    // 节点的子表或类型发生变化, 只影响路径经过该节点的访问器缓存
+    void UpdateNodeStructVersion(FNBTAttributeID ID) { Allocator.IncNodeStructVersion(ID); }
+
+    void BubbleSubtreeVersionAlongPathForID(FNBTAttributeID LeafID); // 客户端专用, 同一帧内每个节点只自增一次
 
     bool IsRemainingSpaceSupportCopy(FNBTAttributeID SourceID, const FNBTContainer& Source);
     bool IsRemainingSpaceSupportDoubleCopy(FNBTAttributeID A, FNBTAttributeID B);
@@ -139,6 +369,48 @@ public:
 
     void CopyFrom(const FNBTContainer& Other);
 
+    // 负载竞技场: 开启后外置负载从整块内存中切分, Reset/Clear/CopyFrom 时整体释放, 适合频繁整体重建的容器
+    // 设置在下一次 Reset/Clear/CopyFrom 时生效
+    // 只有侧池中的负载(Map子项表/软路径/双精度向量等)来自竞技场; 字符串与数组的缓冲区仍由全局分配器管理, 以它们为主的容器释放开销基本不变
+    void SetUsePayloadArena(bool bUseArena);
+
+    bool IsUsingPayloadArena() const;
+
+    // 增量整理: 把尾部稀疏块中的节点搬到前部空洞, 改写父节点中的子ID, 最后释放尾部空块
+    // 可跨帧反复调用, TimeBudgetMs 为本次调用的时间预算, 返回true表示整理已完成
+    // 被搬移的节点会获得新ID, 网络同步时表现为普通的删除/新增/更新操作; 客户端镜像容器的布局由服务器决定, 调用无效果
+    // 写入批次未提交时不进行整理, 直接返回false
+    bool CompactIncremental(float TimeBudgetMs);
+
+    bool IsCompacting() const { return Compaction.bActive; }
+
+    // 批量写入: Begin/Commit 之间的写操作不再各自自增容器数据版本, 也不再各自从根冒泡子树版本
+    // 提交时每个受影响的祖先只自增一次, 容器数据版本只自增一次; 可嵌套, 以最外层提交为准
+    // C++ 中优先使用 FNBTWriteBatchScope; 脚本中漏掉的提交由所属组件在帧末强制补上
+    void BeginWriteBatch();
+
+    void CommitWriteBatch();
+
+    bool IsInWriteBatch() const { return WriteBatch.Depth > 0; }
+
+    // 帧末看门狗: 批次仍未提交时报错并按最外层提交处理, 避免数据版本与子树版本从此停止推进
+    void ForceCommitWriteBatch();
+
+    // 延迟子树版本: 开启后写操作不再逐层自增祖先的子树版本, 只记录被修改的节点
+    // 访问器读取子树版本(IsSubtreeChanged/MarkSubtree)前或调用 FlushSubtreeVersions 时统一传播; 关闭时立即传播未处理的修改
+    void SetLazySubtreeVersion(bool bLazy);
+
+    bool IsLazySubtreeVersion() const { return LazySubtree.bEnabled; }
+
+    // Team 条件使用的连接队伍解析; 队伍归属变化后调用 InvalidateReplicateFilter 让各连接按新结果增删子树
+    void SetConnectionTeamResolver(const FNBTConnectionTeamResolver& Resolver) { ConnectionTeamResolver = Resolver; }
+
+    void InvalidateReplicateFilter();
+
+    FORCEINLINE void FlushSubtreeVersions() const {
+        if (LazySubtree.DirtyIDs.Num() > 0) PropagateLazySubtreeVersions();
+    }
+
     int32 GetContainerDataVersion() const { return ContainerDataVersion; }
 
     int32 GetContainerStructVersion() const { return ContainerStructVersion; }
@@ -147,6 +419,9 @@ public:
 
     FNBTDataAccessor GetAccessor() const;
 
+    // 通过预编译路径获取访问器, 路径不存在时返回的访问器仍然可以用于 EnsureAndSet 等创建操作
+    FNBTDataAccessor GetAccessor(const FNBTCompiledPath& CompiledPath) const;
+
     FString ToString() const;
 
     FString ToDebugString() const;
@@ -170,6 +445,24 @@ private:
 
     void GetNodeStatisticsRecursive(FNBTAttributeID NodeID, FArzNBTContainerStats& Stats, int32& CurrentDepth) const;
 
+    // 计算相对基线的差分并写入, 对该连接隐藏的节点视为不存在
+    void WriteDelta(FBitWriter& Writer, const FArzNBTContainerBaseState& OldState, const FReplicateFilter& Filter);
+
+    // 全量同步, 格式与 SerializeData 的网络模式一致
+    void WriteFullSync(FBitWriter& Writer, const FReplicateFilter& Filter);
+
+    // 写入单个节点的值, 带条件的Map只写入对该连接可见的键
+    void SerializeNodeForNet(FArchive& Ar, FNBTAttributeID ID, FNBTAttribute& Attr, const FReplicateFilter& Filter);
+
+    // 写入大节点的修改: 基线版本与影子一致且补丁更小时发送补丁, 否则发送完整值; 随后把影子更新到当前版本
+    void WriteFieldUpdate(FBitWriter& Writer, const FArzNBTContainerBaseState& OldState, FNBTAttributeID ID, FNBTAttribute& Attr);
+
+    void ValidateDeltaCache();
+
+    bool ReplayCachedDelta(FBitWriter& Writer, uint64 BaselineClock, int32 BaselineVersion, const FReplicateFilterKey& BaselineFilter, const FReplicateFilterKey& FilterKey);
+
+    void StoreCachedDelta(FBitWriter& Writer, int64 StartBits, uint64 BaselineClock, int32 BaselineVersion, const FReplicateFilterKey& BaselineFilter, const FReplicateFilterKey& FilterKey);
+
     inline int32* GetAttributeSubtreeVersion(FNBTAttributeID ID) const {
         return Allocator.GetNodeSubtreeVersion(ID);
     }
@@ -178,6 +471,10 @@ private:
         Allocator.IncNodeSubtreeVersion(ID);
     }
 
+    inline int32* GetAttributeStructVersion(FNBTAttributeID ID) const {
+        return Allocator.GetNodeStructVersion(ID);
+    }
+
     inline FNBTAttribute* GetAttribute(FNBTAttributeID ID) const {
         return Allocator.GetAttribute(ID);
     }
@@ -190,41 +487,80 @@ private:
         return Allocator.IsNodeValid(ID);
     }
 
+    FNBTAttributeID ResolveCompiledPathID(const FNBTCompiledPath& CompiledPath) const;
+
+    inline FNBTPayloadPool& GetPayloadPool() const {
+        return Allocator.GetPayloadPool();
+    }
+
     FNBTAttributeID GetRootID() const { return RootID; }
 };
 
+// 批量写入作用域, 析构时提交
+class FNBTWriteBatchScope {
+public:
+    explicit FNBTWriteBatchScope(FNBTContainer& InContainer) : Container(InContainer) {
+        Container.BeginWriteBatch();
+    }
+
+    ~FNBTWriteBatchScope() {
+        Container.CommitWriteBatch();
+    }
+
+    FNBTWriteBatchScope(const FNBTWriteBatchScope&) = delete;
+    FNBTWriteBatchScope& operator=(const FNBTWriteBatchScope&) = delete;
+
+private:
+    FNBTContainer& Container;
+};
+
 class FArzNBTContainerBaseState : public INetDeltaBaseState {
 public:
     int32 ContainerVersion;
 
-    TArray<FNBTAttributeChunkMetaData> VersionChunks;
+    TArray<FNBTChunkVersionSnapshotRef> VersionChunks; // 按块共享的只读快照, 空块为空指针
+
+    uint64 ChangeClock = 0; // 快照时分配器的变更时钟, 差分时只访问之后变更过的块
+
+    FNBTContainer::FReplicateFilterKey FilterKey; // 快照时该连接的同步条件判定结果, 被隐藏的节点在快照中记为不存在
 
     FArzNBTContainerBaseState() : ContainerVersion(0) {}
 
-    void CreateVersionSnapshotFromContainer(const FNBTContainer& Container) {
+    void CreateVersionSnapshotFromContainer(const FNBTContainer& Container, const FNBTContainer::FReplicateFilter& Filter) {
         ContainerVersion = Container.ContainerDataVersion;
+        ChangeClock = Container.Allocator.GetChangeClock();
+        FilterKey = Filter.Key;
 
         const int32 NumChunks = Container.Allocator.GetChunkCount();
         VersionChunks.Reset(NumChunks);
-        VersionChunks.SetNum(NumChunks);
         for (int32 i = 0; i < NumChunks; ++i) {
-            if (const FNBTAttributeChunkMetaData* Meta = Container.Allocator.GetChunkMetadata(i)) {
-                FMemory::Memcpy(&VersionChunks[i], Meta, sizeof(FNBTAttributeChunkMetaData));
+            FNBTChunkVersionSnapshotRef Snapshot = Container.AcquireChunkSnapshot(i);
+            const uint64 HiddenMask = Filter.GetHiddenMask(i);
+            if (Snapshot.IsValid() && HiddenMask != 0) {
+                // 含有隐藏节点的块为该连接单独拷贝一份, 其余块仍然共享
+                TSharedPtr<FNBTChunkVersionSnapshot> Masked = MakeShared<FNBTChunkVersionSnapshot>(*Snapshot);
+                Masked->UsedMask &= ~HiddenMask;
+                Snapshot = Masked;
             }
+            VersionChunks.Add(MoveTemp(Snapshot));
         }
     }
 
+    const FNBTChunkVersionSnapshot* GetChunkSnapshot(int32 ChunkIndex) const {
+        return VersionChunks.IsValidIndex(ChunkIndex) ? VersionChunks[ChunkIndex].Get() : nullptr;
+    }
+
     const int32* GetVersionForID(FNBTAttributeID ID) const {
         if (!ID.IsValid()) return nullptr;
 
-        const uint16 ChunkIndex = ID.Index >> FNBTAllocator::CHUNK_SHIFT;
+        const uint32 ChunkIndex = ID.Index >> FNBTAllocator::CHUNK_SHIFT;
         const uint16 LocalIndex = ID.Index & FNBTAllocator::CHUNK_MASK;
 
-        if (!VersionChunks.IsValidIndex(ChunkIndex)) return nullptr;
+        const FNBTChunkVersionSnapshot* Chunk = GetChunkSnapshot(ChunkIndex);
+        if (!Chunk) return nullptr;
 
-        const FNBTAttributeChunkMetaData& Chunk = VersionChunks[ChunkIndex];
-        if ((Chunk.UsedMask & (1ULL << LocalIndex)) && Chunk.Generations[LocalIndex] == ID.Generation) {
-            return &Chunk.Versions[LocalIndex];
+        if ((Chunk->UsedMask & (1ULL << LocalIndex)) && Chunk->Generations[LocalIndex] == ID.Generation) {
+            return &Chunk->Versions[LocalIndex];
         }
 
         return nullptr;
@@ -234,12 +570,13 @@ public:
         FArzNBTContainerBaseState* Other = static_cast<FArzNBTContainerBaseState*>(OtherState);
         if (!Other) return false;
 
-        if (ContainerVersion == Other->ContainerVersion) return true;
+        if (ContainerVersion == Other->ContainerVersion && FilterKey == Other->FilterKey) return true;
         return false;
     }
 
     virtual void CountBytes(FArchive& Ar) const override {
         Ar.CountBytes(sizeof(FArzNBTContainerBaseState), sizeof(FArzNBTContainerBaseState));
+        // 快照由多个基线共享, 只计入引用本身, 避免按连接数重复统计
         VersionChunks.CountBytes(Ar);
     }
 };
@@ -0,0 +1,346 @@
+﻿#include "NBTFieldDelta.h"
+
+namespace NBTFieldDelta {
+    template <typename E>
+    FORCEINLINE bool IsElementChanged(const E* BaseData, int32 BaseNum, const TArray<E>& Current, int32 Index) {
+        return Index >= BaseNum || FMemory::Memcmp(&BaseData[Index], &Current[Index], sizeof(E)) != 0;
+    }
+
+    template <typename E>
+    void WriteArrayPatch(FArchive& Ar, const FNBTFieldShadow& Base, const TArray<E>& Current) {
+        const E* BaseData = reinterpret_cast<const E*>(Base.ArrayBytes.GetData());
+        const int32 BaseNum = Base.Num;
+        const int32 NewNum = Current.Num();
+
+        // 收集修改区间, 新增的尾部元素总是落在区间内
+        TArray<TPair<int32, int32>, TInlineAllocator<8>> Ranges;
+        int32 Index = 0;
+        while (Index < NewNum) {
+            if (!IsElementChanged(BaseData, BaseNum, Current, Index)) {
+                ++Index;
+                continue;
+            }
+            int32 End = Index + 1;
+            for (int32 Scan = End; Scan < NewNum && Scan - End < FNBTFieldDelta::RANGE_MERGE_GAP; ++Scan) {
+                if (IsElementChanged(BaseData, BaseNum, Current, Scan)) {
+                    End = Scan + 1;
+                }
+            }
+            Ranges.Emplace(Index, End - Index);
+            Index = End;
+        }
+
+        uint32 BaseNumPacked = BaseNum;
+        uint32 NewNumPacked = NewNum;
+        uint32 RangeCount = Ranges.Num();
+        Ar.SerializeIntPacked(BaseNumPacked);
+        Ar.SerializeIntPacked(NewNumPacked);
+        Ar.SerializeIntPacked(RangeCount);
+        for (const TPair<int32, int32>& Range : Ranges) {
+            uint32 Start = Range.Key;
+            uint32 Count = Range.Value;
+            Ar.SerializeIntPacked(Start);
+            Ar.SerializeIntPacked(Count);
+            for (int32 i = Range.Key; i < Range.Key + Range.Value; ++i) {
+                E Element = Current[i];
+                Ar << Element;
+            }
+        }
+    }
+
+    template <typename E>
+    bool ApplyArrayPatch(FBitReader& Ar, TArray<E>& Target) {
+        uint32 BaseNum = 0, NewNum = 0, RangeCount = 0;
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(NewNum);
+        Ar.SerializeIntPacked(RangeCount);
+        if (Ar.IsError() || BaseNum != static_cast<uint32>(Target.Num())) return false;
+        // 新增元素必须全部由补丁提供, 超出剩余数据量的长度视为损坏
+        if (NewNum > BaseNum && static_cast<int64>(NewNum - BaseNum) * sizeof(E) * 8 > Ar.GetBitsLeft()) return false;
+
+        TArray<E> Result(Target);
+        Result.SetNumZeroed(NewNum);
+        uint32 Covered = 0; // 已覆盖到的位置, 区间必须递增且不重叠
+        uint32 NewElements = 0;
+        for (uint32 r = 0; r < RangeCount; ++r) {
+            uint32 Start = 0, Count = 0;
+            Ar.SerializeIntPacked(Start);
+            Ar.SerializeIntPacked(Count);
+            if (Ar.IsError() || Start < Covered || Count > NewNum || Start > NewNum - Count) return false;
+            for (uint32 i = Start; i < Start + Count; ++i) {
+                Ar << Result[i];
+                if (i >= BaseNum) ++NewElements;
+            }
+            if (Ar.IsError()) return false;
+            Covered = Start + Count;
+        }
+        if (NewNum > BaseNum && NewElements != NewNum - BaseNum) return false;
+
+        Target = MoveTemp(Result);
+        return true;
+    }
+
+    // 公共前后缀之外的部分即为拼接区间
+    template <typename E>
+    void FindSplice(const E* Base, int32 BaseNum, const E* Current, int32 NewNum, int32& OutStart, int32& OutRemoveCount, int32& OutInsertCount) {
+        const int32 MaxCommon = FMath::Min(BaseNum, NewNum);
+        int32 Prefix = 0;
+        while (Prefix < MaxCommon && Base[Prefix] == Current[Prefix]) ++Prefix;
+        int32 Suffix = 0;
+        while (Suffix < MaxCommon - Prefix && Base[BaseNum - 1 - Suffix] == Current[NewNum - 1 - Suffix]) ++Suffix;
+        OutStart = Prefix;
+        OutRemoveCount = BaseNum - Prefix - Suffix;
+        OutInsertCount = NewNum - Prefix - Suffix;
+    }
+
+    FORCEINLINE uint32 HashID(const FNBTAttributeID& ID, uint32 Crc) {
+        const uint32 Parts[2] = {static_cast<uint32>(ID.Index), static_cast<uint32>(ID.Generation)}; // 宽ID模式下结构体含填充, 逐字段计算
+        return FCrc::MemCrc32(Parts, sizeof(Parts), Crc);
+    }
+
+    bool ReadSpliceHeader(FBitReader& Ar, int32 CurrentNum, uint32& OutStart, uint32& OutRemoveCount) {
+        uint32 BaseNum = 0;
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(OutStart);
+        Ar.SerializeIntPacked(OutRemoveCount);
+        if (Ar.IsError() || BaseNum != static_cast<uint32>(CurrentNum)) return false;
+        return OutStart <= BaseNum && OutRemoveCount <= BaseNum - OutStart;
+    }
+}
+
+bool FNBTFieldDelta::IsPatchCandidate(const FNBTAttribute& Attr) {
+    switch (Attr.GetType()) {
+#define ARZ_NBT_ARRAY_CANDIDATE_CASE(EnumName, ElementType) \
+        case ENBTAttributeType::EnumName: return Attr.GetUnchecked<TArray<ElementType>>().Num() >= MIN_ELEMENTS;
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayInt8, int8)
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayInt16, int16)
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayInt32, int32)
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayInt64, int64)
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayFloat32, float)
+        ARZ_NBT_ARRAY_CANDIDATE_CASE(ArrayDouble, double)
+#undef ARZ_NBT_ARRAY_CANDIDATE_CASE
+        case ENBTAttributeType::String:
+            return Attr.GetUnchecked<FString>().Len() >= MIN_ELEMENTS;
+        case ENBTAttributeType::Map:
+            return Attr.GetMapData()->Children.Num() >= MIN_ELEMENTS;
+        case ENBTAttributeType::List:
+            return Attr.GetListData()->Children.Num() >= MIN_ELEMENTS;
+        default:
+            return false;
+    }
+}
+
+void FNBTFieldDelta::CaptureShadow(const FNBTAttribute& Attr, int32 Version, FNBTFieldShadow& OutShadow) {
+    OutShadow.Type = Attr.GetType();
+    OutShadow.Version = Version;
+    OutShadow.Num = 0;
+    OutShadow.ArrayBytes.Reset();
+    OutShadow.String.Reset();
+    OutShadow.MapChildren.Reset();
+    OutShadow.ListChildren.Reset();
+
+    if (Attr.IsArrayType()) {
+        Attr.VisitValue([&OutShadow]<typename T0>(T0& Value) {
+            using T = std::decay_t<T0>;
+            if constexpr (TIsTArray<T>::Value) {
+                OutShadow.Num = Value.Num();
+                OutShadow.ArrayBytes.Append(reinterpret_cast<const uint8*>(Value.GetData()), Value.Num() * Value.GetTypeSize());
+            }
+        });
+    } else if (const FString* String = Attr.TryGetPtr<FString>()) {
+        OutShadow.String = *String;
+        OutShadow.Num = String->Len();
+    } else if (const FNBTMapData* MapData = Attr.GetMapData()) {
+        OutShadow.MapChildren = MapData->Children;
+        OutShadow.Num = MapData->Children.Num();
+    } else if (const FNBTListData* ListData = Attr.GetListData()) {
+        OutShadow.ListChildren.Append(ListData->Children);
+        OutShadow.Num = ListData->Children.Num();
+    }
+    OutShadow.Checksum = ComputeChecksum(Attr);
+}
+
+uint32 FNBTFieldDelta::ComputeChecksum(const FNBTAttribute& Attr) {
+    uint32 Crc = 0;
+    if (Attr.IsArrayType()) {
+        Attr.VisitValue([&Crc]<typename T0>(T0& Value) {
+            using T = std::decay_t<T0>;
+            if constexpr (TIsTArray<T>::Value) {
+                Crc = FCrc::MemCrc32(Value.GetData(), Value.Num() * Value.GetTypeSize());
+            }
+        });
+    } else if (const FString* String = Attr.TryGetPtr<FString>()) {
+        Crc = FCrc::StrCrc32(**String); // 逐字符按32位计算, 与TCHAR宽度无关
+    } else if (const FNBTMapData* MapData = Attr.GetMapData()) {
+        for (const FNBTMapChildren::ElementType& Pair : MapData->Children) {
+            Crc += NBTFieldDelta::HashID(Pair.Value, FCrc::StrCrc32(*Pair.Key.ToString().ToLower())); // FName不区分大小写
+        }
+    } else if (const FNBTListData* ListData = Attr.GetListData()) {
+        for (const FNBTAttributeID& ChildID : ListData->Children) {
+            Crc = NBTFieldDelta::HashID(ChildID, Crc);
+        }
+    }
+    return Crc;
+}
+
+bool FNBTFieldDelta::WritePatch(FArchive& Ar, const FNBTFieldShadow& Base, const FNBTAttribute& Current) {
+    if (Base.Type != Current.GetType()) return false;
+
+    uint8 TypeIndex = static_cast<uint8>(Current.GetType());
+    uint32 BaseChecksum = Base.Checksum;
+    Ar << TypeIndex;
+    Ar << BaseChecksum;
+
+    if (Current.IsArrayType()) {
+        Current.VisitValue([&Ar, &Base]<typename T0>(T0& Value) {
+            using T = std::decay_t<T0>;
+            if constexpr (TIsTArray<T>::Value) {
+                NBTFieldDelta::WriteArrayPatch(Ar, Base, Value);
+            }
+        });
+        return true;
+    }
+
+    if (const FString* String = Current.TryGetPtr<FString>()) {
+        int32 Start, RemoveCount, InsertCount;
+        NBTFieldDelta::FindSplice(*Base.String, Base.String.Len(), **String, String->Len(), Start, RemoveCount, InsertCount);
+        uint32 BaseNum = Base.String.Len();
+        uint32 StartPacked = Start;
+        uint32 RemovePacked = RemoveCount;
+        FString Inserted = String->Mid(Start, InsertCount);
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(StartPacked);
+        Ar.SerializeIntPacked(RemovePacked);
+        Ar << Inserted;
+        return true;
+    }
+
+    if (const FNBTListData* ListData = Current.GetListData()) {
+        int32 Start, RemoveCount, InsertCount;
+        NBTFieldDelta::FindSplice(Base.ListChildren.GetData(), Base.ListChildren.Num(), ListData->Children.GetData(), ListData->Children.Num(),
+                                  Start, RemoveCount, InsertCount);
+        uint32 BaseNum = Base.ListChildren.Num();
+        uint32 StartPacked = Start;
+        uint32 RemovePacked = RemoveCount;
+        uint32 InsertPacked = InsertCount;
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(StartPacked);
+        Ar.SerializeIntPacked(RemovePacked);
+        Ar.SerializeIntPacked(InsertPacked);
+        for (int32 i = Start; i < Start + InsertCount; ++i) {
+            FNBTAttributeID ChildID = ListData->Children[i];
+            Ar << ChildID;
+        }
+        return true;
+    }
+
+    if (const FNBTMapData* MapData = Current.GetMapData()) {
+        TArray<FName, TInlineAllocator<8>> Removed;
+        for (const FNBTMapChildren::ElementType& Pair : Base.MapChildren) {
+            if (!MapData->Children.Contains(Pair.Key)) Removed.Add(Pair.Key);
+        }
+        TArray<FNBTMapChildren::ElementType, TInlineAllocator<8>> Changed; // 新增的键, 或同名键指向了新节点
+        for (const FNBTMapChildren::ElementType& Pair : MapData->Children) {
+            const FNBTAttributeID* BaseID = Base.MapChildren.Find(Pair.Key);
+            if (!BaseID || !(*BaseID == Pair.Value)) Changed.Add(Pair);
+        }
+
+        uint32 BaseNum = Base.MapChildren.Num();
+        uint32 RemovedCount = Removed.Num();
+        uint32 ChangedCount = Changed.Num();
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(RemovedCount);
+        for (FName& Key : Removed) {
+            Ar << Key;
+        }
+        Ar.SerializeIntPacked(ChangedCount);
+        for (FNBTMapChildren::ElementType& Pair : Changed) {
+            Ar << Pair.Key;
+            Ar << Pair.Value;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool FNBTFieldDelta::ApplyPatch(FBitReader& Ar, FNBTAttribute& Target) {
+    uint8 TypeIndex = 0;
+    uint32 BaseChecksum = 0;
+    Ar << TypeIndex;
+    Ar << BaseChecksum;
+    if (Ar.IsError() || static_cast<ENBTAttributeType>(TypeIndex) != Target.GetType()) return false;
+    if (BaseChecksum != ComputeChecksum(Target)) return false; // 元素数相同但内容不同的基准同样拒绝
+
+    if (Target.IsArrayType()) {
+        bool bApplied = false;
+        Target.VisitValue([&Ar, &bApplied]<typename T0>(T0& Value) {
+            using T = std::decay_t<T0>;
+            if constexpr (TIsTArray<T>::Value) {
+                bApplied = NBTFieldDelta::ApplyArrayPatch(Ar, Value);
+            }
+        });
+        return bApplied;
+    }
+
+    if (FString* String = Target.TryGetPtr<FString>()) {
+        uint32 Start = 0, RemoveCount = 0;
+        if (!NBTFieldDelta::ReadSpliceHeader(Ar, String->Len(), Start, RemoveCount)) return false;
+        FString Inserted;
+        Ar << Inserted;
+        if (Ar.IsError()) return false;
+        String->RemoveAt(Start, RemoveCount);
+        String->InsertAt(Start, Inserted);
+        return true;
+    }
+
+    if (FNBTListData* ListData = Target.GetListData()) {
+        uint32 Start = 0, RemoveCount = 0, InsertCount = 0;
+        if (!NBTFieldDelta::ReadSpliceHeader(Ar, ListData->Children.Num(), Start, RemoveCount)) return false;
+        Ar.SerializeIntPacked(InsertCount);
+        if (Ar.IsError() || InsertCount > Ar.GetBitsLeft()) return false;
+
+        TArray<FNBTAttributeID, TInlineAllocator<8>> Inserted;
+        Inserted.SetNum(InsertCount);
+        for (FNBTAttributeID& ChildID : Inserted) {
+            Ar << ChildID;
+        }
+        if (Ar.IsError()) return false;
+        ListData->Children.RemoveAt(Start, RemoveCount);
+        ListData->Children.Insert(Inserted.GetData(), Inserted.Num(), Start);
+        return true;
+    }
+
+    if (FNBTMapData* MapData = Target.GetMapData()) {
+        uint32 BaseNum = 0, RemovedCount = 0, ChangedCount = 0;
+        Ar.SerializeIntPacked(BaseNum);
+        Ar.SerializeIntPacked(RemovedCount);
+        if (Ar.IsError() || BaseNum != static_cast<uint32>(MapData->Children.Num()) || RemovedCount > BaseNum) return false;
+
+        TArray<FName, TInlineAllocator<8>> Removed;
+        Removed.SetNum(RemovedCount);
+        for (FName& Key : Removed) {
+            Ar << Key;
+        }
+        Ar.SerializeIntPacked(ChangedCount);
+        if (Ar.IsError() || ChangedCount > Ar.GetBitsLeft()) return false;
+
+        TArray<FNBTMapChildren::ElementType, TInlineAllocator<8>> Changed;
+        Changed.SetNum(ChangedCount);
+        for (FNBTMapChildren::ElementType& Pair : Changed) {
+            Ar << Pair.Key;
+            Ar << Pair.Value;
+        }
+        if (Ar.IsError()) return false;
+
+        for (const FName& Key : Removed) {
+            MapData->Children.Remove(Key);
+        }
+        for (const FNBTMapChildren::ElementType& Pair : Changed) {
+            MapData->Children.Emplace(Pair.Key, Pair.Value);
+        }
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NBTAttribute.h"
+#include "Serialization/BitReader.h"
+
+// 字段级差分: 大数组/字符串/Map/List被修改时, 只发送相对于上次发送值的补丁, 而不是整个值
+// 服务器为发送过Update的大节点保留一份值副本(影子), 只有连接基线中的节点版本与影子版本一致时才能打补丁
+// 数组: 按元素区间覆盖; 字符串/List: 一次拼接(删除一段, 插入一段); Map: 删除的键 + 新增或重定向的键
+// 补丁头携带基准值的校验和: 基线可能尚未被确认, 丢包后客户端的值与基准不同, 此时客户端跳过补丁, 等待重发的完整值
+
+struct FNBTFieldShadow {
+    ENBTAttributeType Type = ENBTAttributeType::Empty;
+    int32 Version = INDEX_NONE;         // 影子对应的节点数据版本
+    int32 Num = 0;                      // 数组元素数 / 字符串长度
+    uint32 Checksum = 0;                // 影子值的校验和, 见 FNBTFieldDelta::ComputeChecksum
+    TArray<uint8> ArrayBytes;           // 数组元素的原始内存, 逐元素按位比较
+    FString String;
+    FNBTMapChildren MapChildren;
+    TArray<FNBTAttributeID> ListChildren;
+
+    SIZE_T GetAllocatedSize() const {
+        return ArrayBytes.GetAllocatedSize() + String.GetAllocatedSize() + ListChildren.GetAllocatedSize() +
+               MapChildren.Num() * sizeof(FNBTMapChildren::ElementType);
+    }
+};
+
+class FNBTFieldDelta {
+public:
+    static constexpr int32 MIN_ELEMENTS = 32;   // 元素/字符/子项数低于该值的节点总是发送完整值, 不保留影子
+    static constexpr int32 RANGE_MERGE_GAP = 4; // 数组中间隔不超过该数量的修改区间合并, 省去区间头
+
+    // 节点当前值是否值得保留影子并尝试补丁
+    static bool IsPatchCandidate(const FNBTAttribute& Attr);
+
+    static void CaptureShadow(const FNBTAttribute& Attr, int32 Version, FNBTFieldShadow& OutShadow);
+
+    // 与平台和Map内部顺序无关的值校验和: 两端FName索引不同, Map子项按键名与子节点ID无序累加
+    static uint32 ComputeChecksum(const FNBTAttribute& Attr);
+
+    // 写入从影子到当前值的补丁, 类型不一致等无法打补丁的情况返回false
+    static bool WritePatch(FArchive& Ar, const FNBTFieldShadow& Base, const FNBTAttribute& Current);
+
+    // 在当前值上应用补丁; 当前值的校验和与补丁的基准不符或数据损坏时返回false, 节点保持原值
+    static bool ApplyPatch(FBitReader& Ar, FNBTAttribute& Target);
+};
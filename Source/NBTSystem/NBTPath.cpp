@@ -0,0 +1,94 @@
+﻿#include "NBTPath.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace {
+
+struct FNBTPathKey {
+    const FNBTPathNode* Parent = nullptr;
+    FName Name;
+    int32 Index = 0;
+    bool bIsName = false;
+
+    bool operator==(const FNBTPathKey& Other) const {
+        return Parent == Other.Parent && bIsName == Other.bIsName && (bIsName ? Name == Other.Name : Index == Other.Index);
+    }
+
+    friend uint32 GetTypeHash(const FNBTPathKey& Key) {
+        const uint32 SegmentHash = Key.bIsName ? GetTypeHash(Key.Name) : ::GetTypeHash(Key.Index) ^ 0x9E3779B9u;
+        return HashCombineFast(GetTypeHash(Key.Parent), SegmentHash);
+    }
+};
+
+// 全局路径表: 只持有弱引用, 路径节点的生命周期由使用者决定
+// 已失效的条目在表增长到阈值时统一清理
+struct FNBTPathTable {
+    static constexpr int32 MIN_TRIM_THRESHOLD = 1024;
+
+    FCriticalSection Mutex;
+    TMap<FNBTPathKey, TWeakPtr<const FNBTPathNode>> Entries;
+    int32 NextTrimThreshold = MIN_TRIM_THRESHOLD;
+
+    static FNBTPathTable& Get() {
+        static FNBTPathTable* Instance = new FNBTPathTable(); // 不随静态析构销毁, 静态持有的路径可能晚于该表析构
+        return *Instance;
+    }
+
+    int32 TrimLocked() {
+        const int32 Before = Entries.Num();
+        for (auto It = Entries.CreateIterator(); It; ++It) {
+            if (!It.Value().IsValid()) It.RemoveCurrent();
+        }
+        NextTrimThreshold = FMath::Max(MIN_TRIM_THRESHOLD, Entries.Num() * 2);
+        return Before - Entries.Num();
+    }
+};
+
+}
+
+FNBTPath FNBTPath::Intern(const TSharedPtr<const FNBTPathNode>& Parent, const FNBTPathSegment& Segment) {
+    FNBTPathKey Key;
+    Key.Parent = Parent.Get();
+    if (const FName* Name = Segment.TryGet<FName>()) {
+        Key.bIsName = true;
+        Key.Name = *Name;
+    } else {
+        Key.Index = Segment.Get<int32>();
+    }
+
+    FNBTPath Result;
+    FNBTPathTable& Table = FNBTPathTable::Get();
+    FScopeLock Lock(&Table.Mutex);
+
+    TWeakPtr<const FNBTPathNode>& Entry = Table.Entries.FindOrAdd(Key);
+    Result.Node = Entry.Pin();
+    if (Result.Node.IsValid()) {
+        return Result;
+    }
+
+    // 未命中或旧节点已失效(旧父节点的地址被复用), 新建节点
+    TSharedPtr<FNBTPathNode> NewNode = MakeShared<FNBTPathNode>();
+    NewNode->Parent = Parent;
+    NewNode->Segment = Segment;
+    NewNode->Depth = Parent.IsValid() ? Parent->Depth + 1 : 1;
+    NewNode->Hash = HashCombineFast(Parent.IsValid() ? Parent->Hash : 0, GetTypeHash(FNBTPathKey{nullptr, Key.Name, Key.Index, Key.bIsName}));
+    Entry = NewNode;
+    Result.Node = NewNode;
+
+    if (Table.Entries.Num() >= Table.NextTrimThreshold) {
+        Table.TrimLocked();
+    }
+    return Result;
+}
+
+int32 FNBTPath::TrimTable() {
+    FNBTPathTable& Table = FNBTPathTable::Get();
+    FScopeLock Lock(&Table.Mutex);
+    return Table.TrimLocked();
+}
+
+int32 FNBTPath::GetTableSize() {
+    FNBTPathTable& Table = FNBTPathTable::Get();
+    FScopeLock Lock(&Table.Mutex);
+    return Table.Entries.Num();
+}
@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+// 路径段: Map键或List下标
+using FNBTPathSegment = TVariant<FName, int32>;
+
+// 驻留路径节点: 父节点 + 一个路径段, 创建后不可变
+// 相同的 (父节点, 路径段) 在全局路径表中只存在一份
+struct FNBTPathNode {
+    TSharedPtr<const FNBTPathNode> Parent; // 强引用, 子路径存活期间父路径一定存活
+    FNBTPathSegment Segment;
+    int32 Depth = 0;   // 路径长度, 根的直接子节点为1
+    uint32 Hash = 0;   // 整条路径的哈希
+};
+
+using FNBTPathNodeArray = TArray<const FNBTPathNode*, TInlineAllocator<16>>;
+
+// 不可变的驻留路径, 拷贝只增加引用计数
+// 相同的路径总是指向同一个节点, 路径相等与前缀判断只需比较指针
+// 创建子路径时命中路径表则没有内存分配; 路径表线程安全
+class NBTSYSTEM_API FNBTPath {
+    TSharedPtr<const FNBTPathNode> Node; // 空表示根
+
+public:
+    FNBTPath() = default;
+
+    int32 Num() const { return Node.IsValid() ? Node->Depth : 0; }
+
+    bool IsRoot() const { return !Node.IsValid(); }
+
+    uint32 GetHash() const { return Node.IsValid() ? Node->Hash : 0; }
+
+    const FNBTPathNode* GetNode() const { return Node.Get(); }
+
+    // 最后一段, 根路径不可调用
+    const FNBTPathSegment& Last() const {
+        check(Node.IsValid());
+        return Node->Segment;
+    }
+
+    FNBTPath Child(FName Key) const { return Intern(Node, FNBTPathSegment(TInPlaceType<FName>(), Key)); }
+
+    FNBTPath Child(int32 Index) const { return Intern(Node, FNBTPathSegment(TInPlaceType<int32>(), Index)); }
+
+    FNBTPath Child(const FNBTPathSegment& Segment) const { return Intern(Node, Segment); }
+
+    FNBTPath GetParent() const {
+        FNBTPath Result;
+        if (Node.IsValid()) Result.Node = Node->Parent;
+        return Result;
+    }
+
+    // 取得长度为 InDepth 的前缀路径节点, InDepth 为0时返回空(根)
+    const FNBTPathNode* GetAncestorNode(int32 InDepth) const {
+        const FNBTPathNode* Current = Node.Get();
+        while (Current && Current->Depth > InDepth) {
+            Current = Current->Parent.Get();
+        }
+        return Current;
+    }
+
+    // 自身是否为 Other 的前缀(包括相等)
+    bool IsPrefixOf(const FNBTPath& Other) const {
+        if (Num() > Other.Num()) return false;
+        return Other.GetAncestorNode(Num()) == Node.Get();
+    }
+
+    // 按从根到叶的顺序取得所有路径节点
+    void GetNodes(FNBTPathNodeArray& OutNodes) const {
+        OutNodes.SetNumUninitialized(Num());
+        const FNBTPathNode* Current = Node.Get();
+        for (int32 i = OutNodes.Num() - 1; i >= 0; --i) {
+            OutNodes[i] = Current;
+            Current = Current->Parent.Get();
+        }
+    }
+
+    void Reset() { Node.Reset(); }
+
+    bool operator==(const FNBTPath& Other) const { return Node == Other.Node; }
+    bool operator!=(const FNBTPath& Other) const { return Node != Other.Node; }
+
+    friend uint32 GetTypeHash(const FNBTPath& Path) { return Path.GetHash(); }
+
+    // 清理路径表中已失效的条目, 返回清理数量; 路径表增长时也会自动清理
+    static int32 TrimTable();
+
+    static int32 GetTableSize();
+
+private:
+    static FNBTPath Intern(const TSharedPtr<const FNBTPathNode>& Parent, const FNBTPathSegment& Segment);
+};
@@ -0,0 +1,167 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/UnrealMemory.h"
+
+// 属性负载侧池: 存放放不进节点内联区的负载(Map子项表/软路径/双精度向量等)
+// 按16字节分级缓存已释放的块, 同尺寸的负载反复创建删除时不再访问全局分配器
+// 可选的竞技场模式: 池内尺寸的块从整块内存(Slab)中顺序切分, 容器 Reset/Clear 时整体释放而不是逐个归还
+// 竞技场只覆盖侧池中的块; 内联存放的 FString/TArray 的字符与元素缓冲区仍由 FMemory 分配, 释放时照常逐个析构
+// 非线程安全, 与所属容器在同一线程使用
+class FNBTPayloadPool {
+public:
+    static constexpr SIZE_T SIZE_CLASS_GRANULARITY = 16;
+    static constexpr int32 NUM_SIZE_CLASSES = 8; // 16 ~ 128 字节
+    static constexpr SIZE_T MAX_POOLED_SIZE = SIZE_CLASS_GRANULARITY * NUM_SIZE_CLASSES;
+    static constexpr uint32 BLOCK_ALIGNMENT = 16;
+    static constexpr SIZE_T SLAB_SIZE = 16 * 1024;
+
+private:
+    struct FFreeBlock {
+        FFreeBlock* Next;
+    };
+
+    FFreeBlock* FreeLists[NUM_SIZE_CLASSES] {};
+
+    bool bArenaEnabled = false;
+    bool bPendingArenaEnabled = false; // 在所有负载释放后才切换模式
+
+    TArray<uint8*> Slabs;
+    uint8* SlabCursor = nullptr;
+    uint8* SlabEnd = nullptr;
+
+    struct {
+        uint32 LiveBlocks = 0;      // 正在被节点使用的块
+        uint32 CachedBlocks = 0;    // 空闲链表中缓存的块
+        uint32 TotalRequests = 0;   // 总申请次数
+        uint32 ReusedRequests = 0;  // 命中缓存的申请次数
+        uint32 ArenaReleases = 0;   // 竞技场整体释放次数
+    } Stats;
+
+public:
+    FNBTPayloadPool() = default;
+    FNBTPayloadPool(const FNBTPayloadPool&) = delete;
+    FNBTPayloadPool& operator=(const FNBTPayloadPool&) = delete;
+
+    ~FNBTPayloadPool() {
+        if (bArenaEnabled) {
+            ReleaseArena();
+        } else {
+            Trim();
+        }
+    }
+
+    void* Allocate(SIZE_T Size) {
+        Stats.TotalRequests++;
+        Stats.LiveBlocks++;
+
+        const int32 SizeClass = GetSizeClass(Size);
+        if (SizeClass == INDEX_NONE) {
+            return FMemory::Malloc(Size, BLOCK_ALIGNMENT);
+        }
+
+        if (FFreeBlock* Block = FreeLists[SizeClass]) {
+            FreeLists[SizeClass] = Block->Next;
+            Stats.CachedBlocks--;
+            Stats.ReusedRequests++;
+            return Block;
+        }
+        if (bArenaEnabled) {
+            return AllocateFromSlab(GetSizeClassBytes(SizeClass));
+        }
+        return FMemory::Malloc(GetSizeClassBytes(SizeClass), BLOCK_ALIGNMENT);
+    }
+
+    // Size 必须与申请时一致
+    void Free(void* Ptr, SIZE_T Size) {
+        if (!Ptr) return;
+        Stats.LiveBlocks--;
+
+        const int32 SizeClass = GetSizeClass(Size);
+        if (SizeClass == INDEX_NONE) {
+            FMemory::Free(Ptr);
+            return;
+        }
+
+        FFreeBlock* Block = static_cast<FFreeBlock*>(Ptr);
+        Block->Next = FreeLists[SizeClass];
+        FreeLists[SizeClass] = Block;
+        Stats.CachedBlocks++;
+    }
+
+    // 把缓存的空闲块还给全局分配器, 竞技场模式下空闲块属于Slab, 不能单独释放
+    void Trim() {
+        if (bArenaEnabled) return;
+        for (FFreeBlock*& Head : FreeLists) {
+            while (Head) {
+                FFreeBlock* Next = Head->Next;
+                FMemory::Free(Head);
+                Head = Next;
+            }
+        }
+        Stats.CachedBlocks = 0;
+    }
+
+    // 整体释放所有Slab, 调用前所有节点必须已经析构
+    void ReleaseArena() {
+        if (!bArenaEnabled) return;
+        for (FFreeBlock*& Head : FreeLists) {
+            Head = nullptr;
+        }
+        for (uint8* Slab : Slabs) {
+            FMemory::Free(Slab);
+        }
+        Slabs.Reset();
+        SlabCursor = nullptr;
+        SlabEnd = nullptr;
+        Stats.LiveBlocks = 0;
+        Stats.CachedBlocks = 0;
+        Stats.ArenaReleases++;
+    }
+
+    // 设置竞技场模式, 在下一次所有负载释放(容器 Reset/Clear)后生效
+    void SetArenaEnabledOnNextReset(bool bEnabled) { bPendingArenaEnabled = bEnabled; }
+
+    // 所有节点析构后由分配器调用: 竞技场模式下整体释放, 并应用待定的模式切换
+    void OnAllPayloadsReleased() {
+        ReleaseArena();
+        if (bPendingArenaEnabled != bArenaEnabled) {
+            Trim();
+            bArenaEnabled = bPendingArenaEnabled;
+        }
+    }
+
+    bool IsArenaEnabled() const { return bArenaEnabled; }
+    bool IsArenaPending() const { return bPendingArenaEnabled; }
+
+    static bool IsPooledSize(SIZE_T Size) { return GetSizeClass(Size) != INDEX_NONE; }
+
+    uint32 GetLiveBlocks() const { return Stats.LiveBlocks; }
+    uint32 GetCachedBlocks() const { return Stats.CachedBlocks; }
+    uint32 GetTotalRequests() const { return Stats.TotalRequests; }
+    uint32 GetReusedRequests() const { return Stats.ReusedRequests; }
+    uint32 GetArenaReleases() const { return Stats.ArenaReleases; }
+    SIZE_T GetArenaBytes() const { return Slabs.Num() * SLAB_SIZE; }
+
+private:
+    void* AllocateFromSlab(SIZE_T Bytes) {
+        if (!SlabCursor || SlabCursor + Bytes > SlabEnd) {
+            uint8* Slab = static_cast<uint8*>(FMemory::Malloc(SLAB_SIZE, BLOCK_ALIGNMENT));
+            Slabs.Add(Slab);
+            SlabCursor = Slab;
+            SlabEnd = Slab + SLAB_SIZE;
+        }
+        void* Result = SlabCursor;
+        SlabCursor += Bytes; // Bytes 为16的倍数, 保持对齐
+        return Result;
+    }
+
+    static int32 GetSizeClass(SIZE_T Size) {
+        if (Size == 0 || Size > MAX_POOLED_SIZE) return INDEX_NONE;
+        return static_cast<int32>((Size - 1) / SIZE_CLASS_GRANULARITY);
+    }
+
+    static SIZE_T GetSizeClassBytes(int32 SizeClass) {
+        return static_cast<SIZE_T>(SizeClass + 1) * SIZE_CLASS_GRANULARITY;
+    }
+};
@@ -0,0 +1,167 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NBTAccessor.h"
+#include "NBTAccessor.inl"
+#include "NBTContainer.h"
+#include <type_traits>
+
+// 类型化视图: 把某个Map节点下的固定字段声明为强类型成员, 供热点玩法代码直接读写
+// 每个字段缓存自己的节点ID, 以及解析时父Map节点的ID和结构版本; 两者都未变时读写不再经过FName哈希和路径解析
+// 视图每次 Bind 都推进绑定代数, 字段缓存的代数不同时重新解析, 重新绑定后不会沿用旧容器或旧节点的ID
+// 写入仍然自增节点版本/容器数据版本并沿父链冒泡子树版本, 网络同步与 IsSubtreeChanged 不受影响
+//
+//     struct FPlayerStatsView : FNBTSchemaView {
+//         TNBTSchemaField<int32> Health {this, TEXT("Health")};
+//         TNBTSchemaField<float> Speed {this, TEXT("Speed")};
+//     };
+//
+//     FPlayerStatsView Stats;
+//     Stats.Bind(Root["Stats"]);
+//     Stats.Health.Set(100);
+//     const float Speed = Stats.Speed.Get(0.f);
+//
+// 字段保存所属视图的地址, 视图不可拷贝/移动; 非线程安全, 与容器在同一线程使用
+class FNBTSchemaView {
+    template <typename T>
+    friend class TNBTSchemaField;
+
+    FNBTDataAccessor Base;
+
+    uint32 BindEpoch = 0;
+
+public:
+    FNBTSchemaView() = default;
+    FNBTSchemaView(const FNBTSchemaView&) = delete;
+    FNBTSchemaView& operator=(const FNBTSchemaView&) = delete;
+
+    // 绑定到一个Map节点, 节点可以暂不存在, 首次写入字段时创建
+    void Bind(const FNBTDataAccessor& InBase) {
+        Base = InBase;
+        ++BindEpoch;
+    }
+
+    bool IsBound() const { return Base.IsContainerValid(); }
+
+    const FNBTDataAccessor& GetBase() const { return Base; }
+
+private:
+    FNBTContainer* GetContainer() const { return Base.Container; }
+
+    // 慢路径: 通过访问器解析父Map节点, 访问器自身的路径缓存仍然有效
+    FNBTAttributeID ResolveBaseID() const {
+        if (Base.ResolvePathInternal(ENBTPathResolveMode::ReadOnly) != ENBTAttributeOpResult::Success) return FNBTAttributeID();
+        return Base.CachedAttributeID;
+    }
+};
+
+template <typename T>
+class TNBTSchemaField {
+    static_assert(TNBTAttributeTypeTraits<T>::bSupported, "Unsupported NBT attribute type");
+    static_assert(TNBTAttributeTypeTraits<T>::Type != ENBTAttributeType::Map && TNBTAttributeTypeTraits<T>::Type != ENBTAttributeType::List,
+                  "Compound fields should be bound as nested views");
+
+    const FNBTSchemaView* Owner;
+    FName Key;
+
+    mutable uint32 BindEpoch = 0; // 缓存对应的视图绑定代数, 视图未绑定时为0
+    mutable FNBTAttributeID BaseID;
+    mutable int32 BaseStructVersion = INDEX_NONE;
+    mutable FNBTAttributeID FieldID; // 字段不存在时为无效ID, 同样按父节点结构版本缓存
+
+public:
+    TNBTSchemaField(const FNBTSchemaView* InOwner, FName InKey) : Owner(InOwner), Key(InKey) {}
+    TNBTSchemaField(const TNBTSchemaField&) = delete;
+    TNBTSchemaField& operator=(const TNBTSchemaField&) = delete;
+
+    FName GetKey() const { return Key; }
+
+    bool IsExists() const { return FindLiveAttribute() != nullptr; }
+
+    TOptional<T> TryGet() const {
+        const FNBTAttribute* Attr = FindLiveAttribute();
+        return Attr ? Attr->GetBaseType<T>() : TOptional<T>();
+    }
+
+    T Get(const T& DefaultValue = T()) const {
+        const FNBTAttribute* Attr = FindLiveAttribute();
+        if (!Attr) return DefaultValue;
+        TOptional<T> Value = Attr->GetBaseType<T>();
+        return Value.IsSet() ? Value.GetValue() : DefaultValue;
+    }
+
+    // 与访问器的 EnsureAndSet 语义一致: 字段不存在时创建, 已存在的其他类型不会被覆盖
+    FNBTAttributeOpResultDetail Set(const T& Value) const {
+        FNBTAttribute* Attr = FindLiveAttribute();
+        if (!Attr) {
+            if (!Owner->IsBound()) return ENBTAttributeOpResult::InvalidContainer;
+            return EnsureAndSetThroughAccessor(Value); // 创建节点会改变父节点结构版本, 下次访问重新解析
+        }
+
+        FNBTContainer* Container = Owner->GetContainer();
+        ENBTAttributeOpResult Result;
+        if (Attr->IsEmpty()) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                Result = Attr->OverriderToBaseType<T>(Container->GetPayloadPool(), Value);
+            } else {
+                Result = Attr->OverriderToBaseTypeRef<T>(Container->GetPayloadPool(), Value);
+            }
+        } else {
+            if constexpr (std::is_arithmetic_v<T>) {
+                Result = Attr->TrySetBaseType<T>(Value);
+            } else {
+                Result = Attr->TrySetBaseTypeRef<T>(Value);
+            }
+        }
+
+        if (Result == ENBTAttributeOpResult::Success) {
+            Container->Allocator.BumpNodeVersion(FieldID);
+            Container->UpdateContainerDataVersion();
+            Container->BubbleSubtreeVersion(FieldID);
+        }
+        return Result;
+    }
+
+    // 需要其他操作(删除/改类型/变化检测)时退回普通访问器
+    FNBTDataAccessor MakeAccessor() const { return Owner->GetBase().MakeAccessFromFName(Key); }
+
+private:
+    FNBTAttribute* FindLiveAttribute() const {
+        if (!Owner->IsBound()) return nullptr;
+        const FNBTAllocator& Allocator = Owner->GetContainer()->Allocator;
+
+        // 快路径: 绑定未变, 父节点仍然存活且子表没有变化, 缓存的字段ID(或字段不存在的结论)仍然成立
+        uint32 LocalIndex;
+        if (BindEpoch == Owner->BindEpoch) {
+            if (const FAttributeChunk* Chunk = Allocator.FindLiveChunk(BaseID, LocalIndex)) {
+                if (Chunk->Meta.StructVersions[LocalIndex] == BaseStructVersion) {
+                    return Allocator.FindLiveAttribute(FieldID);
+                }
+            }
+        }
+
+        BindEpoch = Owner->BindEpoch;
+        BaseID = Owner->ResolveBaseID();
+        FieldID = FNBTAttributeID();
+        BaseStructVersion = INDEX_NONE;
+
+        const FNBTAttribute* BaseAttr = Allocator.FindLiveAttribute(BaseID);
+        if (!BaseAttr) return nullptr;
+        BaseStructVersion = *Allocator.GetNodeStructVersion(BaseID);
+
+        const FNBTMapData* MapData = BaseAttr->GetMapData();
+        if (!MapData) return nullptr;
+        if (const FNBTAttributeID* ChildID = MapData->Children.Find(Key)) {
+            FieldID = *ChildID;
+        }
+        return Allocator.FindLiveAttribute(FieldID);
+    }
+
+    FNBTAttributeOpResultDetail EnsureAndSetThroughAccessor(const T& Value) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return MakeAccessor().template EnsureAndSetBaseType<T>(Value);
+        } else {
+            return MakeAccessor().template EnsureAndSetBaseTypeRef<T>(Value);
+        }
+    }
+};
@@ -6,6 +6,11 @@ public class NBTSystem : ModuleRules {
     public NBTSystem(ReadOnlyTargetRules Target) : base(Target) {
         PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
+        // 宽ID模式: 24位索引 + 16位代, 节点上限从 65534 提升到 16777214
+        // 注意: 服务器与客户端必须使用相同的设置, 开启后Map子项数量以uint32序列化
+        bool bUseWideAttributeID = false;
+        PublicDefinitions.Add("ARZ_NBT_WIDE_ID=" + (bUseWideAttributeID ? "1" : "0"));
+
         PublicDependencyModuleNames.AddRange(
             new string[] {
                 "Core",
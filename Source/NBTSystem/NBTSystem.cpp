@@ -1,6 +1,7 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NBTSystem.h"
+#include "NBTChunkPool.h"
 
 #define LOCTEXT_NAMESPACE "FNBTSystemModule"
 
@@ -13,6 +14,7 @@ void FNBTSystemModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FNBTChunkPool::Get().Trim();
 }
 
 #undef LOCTEXT_NAMESPACE
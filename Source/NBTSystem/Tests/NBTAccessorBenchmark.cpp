@@ -0,0 +1,83 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "NBTAccessor.h"
+#include "NBTContainer.h"
+#include "NBTTestAccess.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NBTAccessorBenchmark {
+    // 旧版访问器的缓存命中路径: 结构版本一致且缓存的块内指针非空时直接解引用
+    // 指针在取得时解析好, 这里只保留命中时的判断, 与旧 ResolvePathInternal 的快路径一致
+    struct FPointerCache {
+        const FNBTContainer* Container = nullptr;
+        int32 CachedContainerStructVersion = INDEX_NONE;
+        FNBTAttributeID CachedAttributeID;
+        FNBTAttribute* CachedAttributePtr = nullptr;
+        int32* CachedAttributeVersionPtr = nullptr;
+        int32* CachedSubtreeVersionPtr = nullptr;
+
+        FORCENOINLINE TOptional<int32> TryGetInt32() const {
+            if (Container == nullptr) return {};
+            if (CachedContainerStructVersion != Container->GetContainerStructVersion()) return {};
+            if (!CachedAttributeID.IsValid() || !CachedAttributePtr || !CachedAttributeVersionPtr || !CachedSubtreeVersionPtr) return {};
+            return FNBTTestAccess::GetBaseType<int32>(*CachedAttributePtr);
+        }
+    };
+}
+
+// 访问器缓存微基准: 以ID句柄(块号/槽位/代数)校验的 TryGetInt32 对比旧的块内指针缓存
+// 两者都走缓存命中路径; 句柄路径每次调用重新定位所在块; 结果只做报告, 单次计时噪声不作为失败条件
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTAccessorHandleCacheBenchmark, "NBTSystem.Benchmark.AccessorHandleCache",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNBTAccessorHandleCacheBenchmark::RunTest(const FString& Parameters) {
+    static constexpr int32 Iterations = 2000000;
+    static constexpr int32 Rounds = 5;
+
+    FNBTContainer Container;
+    FNBTDataAccessor Root = Container.GetAccessor();
+
+    // 目标节点位于几个块之后, 避免只测到0号块
+    for (int32 i = 0; i < 256; ++i) {
+        Root["Filler"][FName(*FString::Printf(TEXT("Key%d"), i))].EnsureAndSetInt32(i);
+    }
+    FNBTDataAccessor Health = Root["Stats"]["Health"];
+    if (!TestTrue(TEXT("Set target value"), Health.EnsureAndSetInt32(100) == ENBTAttributeOpResult::Success)) return false;
+    if (!TestEqual(TEXT("Read through accessor"), Health.TryGetInt32().Get(0), 100)) return false;
+
+    NBTAccessorBenchmark::FPointerCache PointerCache;
+    PointerCache.Container = &Container;
+    PointerCache.CachedContainerStructVersion = Container.GetContainerStructVersion();
+    const FNBTAttributeID StatsID = FNBTTestAccess::FindMapChild(Container, Container.GetRootID(), TEXT("Stats"));
+    PointerCache.CachedAttributeID = FNBTTestAccess::FindMapChild(Container, StatsID, TEXT("Health"));
+    PointerCache.CachedAttributePtr = FNBTTestAccess::GetAttribute(Container, PointerCache.CachedAttributeID);
+    PointerCache.CachedAttributeVersionPtr = FNBTTestAccess::GetAttributeVersion(Container, PointerCache.CachedAttributeID);
+    PointerCache.CachedSubtreeVersionPtr = FNBTTestAccess::GetAttributeSubtreeVersion(Container, PointerCache.CachedAttributeID);
+    if (!TestEqual(TEXT("Read through pointer cache"), PointerCache.TryGetInt32().Get(0), 100)) return false;
+
+    // 多轮交替测量, 各取最快的一轮, 减少调度和频率变化的影响
+    double HandleCost = TNumericLimits<double>::Max();
+    double PointerCost = TNumericLimits<double>::Max();
+    int64 Sum = 0;
+    for (int32 Round = 0; Round < Rounds; ++Round) {
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Iterations; ++i) {
+            Sum += Health.TryGetInt32().Get(0);
+        }
+        HandleCost = FMath::Min(HandleCost, (FPlatformTime::Seconds() - StartTime) * 1e9 / Iterations);
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Iterations; ++i) {
+            Sum += PointerCache.TryGetInt32().Get(0);
+        }
+        PointerCost = FMath::Min(PointerCost, (FPlatformTime::Seconds() - StartTime) * 1e9 / Iterations);
+    }
+
+    TestEqual(TEXT("Checksum"), Sum, static_cast<int64>(100) * Iterations * Rounds * 2);
+    AddInfo(FString::Printf(TEXT("ID handle cache: %.2f ns per TryGetInt32"), HandleCost));
+    AddInfo(FString::Printf(TEXT("Pointer cache: %.2f ns per TryGetInt32 (handle / pointer = %.2f)"), PointerCost, HandleCost / FMath::Max(PointerCost, UE_SMALL_NUMBER)));
+    return true;
+}
+
+#endif
@@ -0,0 +1,104 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "NBTAllocator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 分配选块微基准: 1~1000个块都留有空位(最坏情况, 旧的线性扫描需要遍历全部块), 测量单次 Allocate/Deallocate 的耗时
+// 空闲块按占用数分桶, 选块代价应与块数无关
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTAllocatorChunkSelectBenchmark, "NBTSystem.Benchmark.AllocatorChunkSelect",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNBTAllocatorChunkSelectBenchmark::RunTest(const FString& Parameters) {
+    static constexpr int32 ChunkCounts[] = {1, 10, 100, 1000};
+    static constexpr int32 Iterations = 200000;
+    static constexpr double MaxCostRatio = 4.0; // 允许计时噪声, 线性扫描在1000块时会远超此比例
+
+    double MinCost = TNumericLimits<double>::Max();
+    double MaxCost = 0.0;
+
+    for (const int32 ChunkCount : ChunkCounts) {
+        FNBTAllocator Allocator;
+
+        // 填满目标数量的块, 再从每个块释放一个节点, 让所有块都处于"非满"状态
+        TArray<FNBTAttributeID> IDs;
+        IDs.Reserve(ChunkCount * FNBTAllocator::CHUNK_SIZE);
+        for (int32 i = 0; i < ChunkCount * static_cast<int32>(FNBTAllocator::CHUNK_SIZE); ++i) {
+            IDs.Add(Allocator.Allocate());
+        }
+        if (!TestEqual(TEXT("Chunk count"), static_cast<int32>(Allocator.GetChunkCount()), ChunkCount)) return false;
+        for (int32 i = 0; i < IDs.Num(); i += FNBTAllocator::CHUNK_SIZE) {
+            Allocator.Deallocate(IDs[i]);
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < Iterations; ++i) {
+            const FNBTAttributeID ID = Allocator.Allocate();
+            Allocator.Deallocate(ID);
+        }
+        const double NanosPerOp = (FPlatformTime::Seconds() - StartTime) * 1e9 / Iterations;
+
+        TestEqual(TEXT("Chunk count after benchmark"), static_cast<int32>(Allocator.GetChunkCount()), ChunkCount);
+        AddInfo(FString::Printf(TEXT("%4d chunks: %.1f ns per Allocate+Deallocate"), ChunkCount, NanosPerOp));
+
+        MinCost = FMath::Min(MinCost, NanosPerOp);
+        MaxCost = FMath::Max(MaxCost, NanosPerOp);
+    }
+
+    if (MaxCost > MinCost * MaxCostRatio) {
+        AddError(FString::Printf(TEXT("Allocation cost is not flat: %.1f ns ~ %.1f ns"), MinCost, MaxCost));
+    }
+    return true;
+}
+
+// 版本扫描微基准: 1000个满块, 只读元数据(占用掩码与版本)对比同时读取每个节点负载的全块扫描
+// 网络差分与变更检测只需要前者; 结果只做报告, 单次计时噪声不作为失败条件
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTAllocatorMetadataScanBenchmark, "NBTSystem.Benchmark.AllocatorMetadataScan",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNBTAllocatorMetadataScanBenchmark::RunTest(const FString& Parameters) {
+    static constexpr int32 ChunkCount = 1000;
+    static constexpr int32 Rounds = 20;
+
+    FNBTAllocator Allocator;
+    for (int32 i = 0; i < ChunkCount * static_cast<int32>(FNBTAllocator::CHUNK_SIZE); ++i) {
+        Allocator.Allocate();
+    }
+    if (!TestEqual(TEXT("Chunk count"), static_cast<int32>(Allocator.GetChunkCount()), ChunkCount)) return false;
+
+    // 多轮测量各取最快的一轮
+    double MetadataCost = TNumericLimits<double>::Max();
+    double FullCost = TNumericLimits<double>::Max();
+    int64 MetadataSum = 0;
+    int64 FullSum = 0;
+    for (int32 Round = 0; Round < Rounds; ++Round) {
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex) {
+            const FNBTAttributeChunkMetaData* Meta = Allocator.GetChunkMetadata(ChunkIndex);
+            for (uint64 Mask = Meta->UsedMask; Mask; Mask &= Mask - 1) {
+                MetadataSum += Meta->Versions[FMath::CountTrailingZeros64(Mask)];
+            }
+        }
+        MetadataCost = FMath::Min(MetadataCost, (FPlatformTime::Seconds() - StartTime) * 1e6);
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex) {
+            const FNBTAttributeChunkMetaData* Meta = Allocator.GetChunkMetadata(ChunkIndex);
+            for (uint64 Mask = Meta->UsedMask; Mask; Mask &= Mask - 1) {
+                const uint32 LocalIndex = FMath::CountTrailingZeros64(Mask);
+                const FNBTAttributeID ID(static_cast<FNBTAttributeID::IndexType>((ChunkIndex << FNBTAllocator::CHUNK_SHIFT) | LocalIndex), Meta->Generations[LocalIndex]);
+                const FNBTAttribute* Attr = Allocator.FindLiveAttribute(ID);
+                FullSum += Meta->Versions[LocalIndex] + (Attr ? static_cast<int64>(Attr->GetType()) : 0);
+            }
+        }
+        FullCost = FMath::Min(FullCost, (FPlatformTime::Seconds() - StartTime) * 1e6);
+    }
+
+    // 新分配的节点都是空类型(0), 两种扫描的累加结果应一致
+    TestEqual(TEXT("Checksum"), FullSum, MetadataSum);
+    AddInfo(FString::Printf(TEXT("%d chunks: metadata-only scan %.1f us, full-chunk scan %.1f us (full / metadata = %.2f)"),
+                            ChunkCount, MetadataCost, FullCost, FullCost / FMath::Max(MetadataCost, UE_SMALL_NUMBER)));
+    return true;
+}
+
+#endif
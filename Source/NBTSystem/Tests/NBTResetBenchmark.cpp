@@ -0,0 +1,88 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "NBTAccessor.h"
+#include "NBTContainer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NBTResetBenchmark {
+    static constexpr int32 GroupCount = 50;
+    static constexpr int32 KeysPerGroup = 1000; // 50个Map各1000个键, 连同根与分组约5万个节点
+
+    // 一半节点是内联的 int32, 一半是需要析构的字符串, 接近实际存档中两类负载的比例
+    static void Populate(FNBTContainer& Container, const TArray<FName>& GroupNames, const TArray<FName>& KeyNames, const FString& Text) {
+        FNBTDataAccessor Root = Container.GetAccessor();
+        for (int32 Group = 0; Group < GroupCount; ++Group) {
+            FNBTDataAccessor GroupAccessor = Root[GroupNames[Group]];
+            for (int32 Key = 0; Key < KeysPerGroup; ++Key) {
+                if (Key & 1) {
+                    GroupAccessor[KeyNames[Key]].EnsureAndSetString(Text);
+                } else {
+                    GroupAccessor[KeyNames[Key]].EnsureAndSetInt32(Key);
+                }
+            }
+        }
+    }
+}
+
+// 清空与销毁微基准: 约5万个节点的容器分别测量 Reset (保留块内存), 开启负载竞技场后的 Reset, 以及整个容器析构
+// 结果只做报告, 单次计时噪声不作为失败条件
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTContainerResetBenchmark, "NBTSystem.Benchmark.ContainerReset",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNBTContainerResetBenchmark::RunTest(const FString& Parameters) {
+    using namespace NBTResetBenchmark;
+    static constexpr int32 Rounds = 5;
+    static constexpr int32 ExpectedMinNodes = GroupCount * KeysPerGroup;
+
+    TArray<FName> GroupNames;
+    TArray<FName> KeyNames;
+    for (int32 i = 0; i < GroupCount; ++i) GroupNames.Add(FName(*FString::Printf(TEXT("Group%d"), i)));
+    for (int32 i = 0; i < KeysPerGroup; ++i) KeyNames.Add(FName(*FString::Printf(TEXT("Key%d"), i)));
+    const FString Text = TEXT("A string long enough to need a heap allocation for its payload");
+
+    // 多轮测量各取最快的一轮; 每轮重新填充, 只计清空或析构本身
+    double ResetCost = TNumericLimits<double>::Max();
+    double ArenaResetCost = TNumericLimits<double>::Max();
+    double TeardownCost = TNumericLimits<double>::Max();
+    int32 NodeCount = 0;
+
+    for (int32 Round = 0; Round < Rounds; ++Round) {
+        {
+            FNBTContainer Container;
+            Populate(Container, GroupNames, KeyNames, Text);
+            NodeCount = Container.GetNodeCount();
+            if (!TestTrue(TEXT("Node count"), NodeCount >= ExpectedMinNodes)) return false;
+
+            const double StartTime = FPlatformTime::Seconds();
+            Container.Reset();
+            ResetCost = FMath::Min(ResetCost, (FPlatformTime::Seconds() - StartTime) * 1e3);
+            if (!TestEqual(TEXT("Node count after Reset"), Container.GetNodeCount(), 1)) return false;
+        }
+        {
+            FNBTContainer Container;
+            Container.SetUsePayloadArena(true);
+            Container.Reset(); // 竞技场在下一次清空时生效
+            Populate(Container, GroupNames, KeyNames, Text);
+
+            const double StartTime = FPlatformTime::Seconds();
+            Container.Reset();
+            ArenaResetCost = FMath::Min(ArenaResetCost, (FPlatformTime::Seconds() - StartTime) * 1e3);
+            if (!TestEqual(TEXT("Node count after arena Reset"), Container.GetNodeCount(), 1)) return false;
+        }
+        {
+            TUniquePtr<FNBTContainer> OwnedContainer = MakeUnique<FNBTContainer>();
+            Populate(*OwnedContainer, GroupNames, KeyNames, Text);
+
+            const double StartTime = FPlatformTime::Seconds();
+            OwnedContainer = nullptr;
+            TeardownCost = FMath::Min(TeardownCost, (FPlatformTime::Seconds() - StartTime) * 1e3);
+        }
+    }
+
+    AddInfo(FString::Printf(TEXT("%d nodes: Reset %.3f ms, Reset with payload arena %.3f ms, teardown %.3f ms"),
+                            NodeCount, ResetCost, ArenaResetCost, TeardownCost));
+    return true;
+}
+
+#endif
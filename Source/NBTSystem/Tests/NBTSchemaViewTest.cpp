@@ -0,0 +1,82 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "NBTSchemaView.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NBTSchemaViewTest {
+    // 与 NBTSchemaView.h 中的示例一致
+    struct FPlayerStatsView : FNBTSchemaView {
+        TNBTSchemaField<int32> Health {this, TEXT("Health")};
+        TNBTSchemaField<float> Speed {this, TEXT("Speed")};
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTSchemaViewTest, "NBTSystem.SchemaView.ReadWrite",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNBTSchemaViewTest::RunTest(const FString& Parameters) {
+    FNBTContainer Container;
+    FNBTDataAccessor Root = Container.GetAccessor();
+
+    NBTSchemaViewTest::FPlayerStatsView Stats;
+    Stats.Bind(Root["Stats"]);
+    TestTrue(TEXT("Bound"), Stats.IsBound());
+
+    // 字段与父Map都还不存在
+    TestFalse(TEXT("Health missing"), Stats.Health.IsExists());
+    TestEqual(TEXT("Speed default"), Stats.Speed.Get(2.f), 2.f);
+
+    // 首次写入经过访问器创建节点, 之后走缓存的字段ID
+    TestTrue(TEXT("Create Health"), Stats.Health.Set(100) == ENBTAttributeOpResult::Success);
+    TestEqual(TEXT("Read Health"), Stats.Health.Get(0), 100);
+    TestTrue(TEXT("Update Health"), Stats.Health.Set(80) == ENBTAttributeOpResult::Success);
+    TestEqual(TEXT("Accessor sees Health"), Root["Stats"]["Health"].TryGetInt32().Get(0), 80);
+
+    // 其他代码写入同一节点后, 视图读到新值
+    Root["Stats"]["Health"].EnsureAndSetInt32(60);
+    TestEqual(TEXT("View sees accessor write"), Stats.Health.Get(0), 60);
+
+    TestTrue(TEXT("Create Speed"), Stats.Speed.Set(1.5f) == ENBTAttributeOpResult::Success);
+    TestEqual(TEXT("Read Speed"), Stats.Speed.TryGet().Get(0.f), 1.5f);
+
+    // 写入推进数据版本, 网络同步与变化检测依赖于此
+    const int32 DataVersion = Container.GetContainerDataVersion();
+    Stats.Health.Set(59);
+    TestTrue(TEXT("Write bumps data version"), Container.GetContainerDataVersion() > DataVersion);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNBTSchemaViewRebindTest, "NBTSystem.SchemaView.Rebind",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNBTSchemaViewRebindTest::RunTest(const FString& Parameters) {
+    FNBTContainer ContainerA;
+    FNBTContainer ContainerB;
+    FNBTDataAccessor RootA = ContainerA.GetAccessor();
+    FNBTDataAccessor RootB = ContainerB.GetAccessor();
+    RootA["PlayerA"]["Health"].EnsureAndSetInt32(100);
+    RootA["PlayerB"]["Health"].EnsureAndSetInt32(50);
+    RootB["Player"]["Health"].EnsureAndSetInt32(10);
+
+    NBTSchemaViewTest::FPlayerStatsView Stats;
+    Stats.Bind(RootA["PlayerA"]);
+    TestEqual(TEXT("PlayerA"), Stats.Health.Get(0), 100);
+
+    // 旧的父节点依然存活且未变化, 字段也不能继续使用旧的缓存
+    Stats.Bind(RootA["PlayerB"]);
+    TestEqual(TEXT("Rebind within container"), Stats.Health.Get(0), 50);
+    Stats.Health.Set(49);
+    TestEqual(TEXT("Write lands on PlayerB"), RootA["PlayerB"]["Health"].TryGetInt32().Get(0), 49);
+    TestEqual(TEXT("PlayerA untouched"), RootA["PlayerA"]["Health"].TryGetInt32().Get(0), 100);
+
+    // 换到另一个容器后, 旧ID不能拿到新容器的分配器中查找
+    Stats.Bind(RootB["Player"]);
+    TestEqual(TEXT("Rebind across containers"), Stats.Health.Get(0), 10);
+    Stats.Health.Set(11);
+    TestEqual(TEXT("Write lands in container B"), RootB["Player"]["Health"].TryGetInt32().Get(0), 11);
+    TestEqual(TEXT("Container A untouched"), RootA["PlayerB"]["Health"].TryGetInt32().Get(0), 49);
+    return true;
+}
+
+#endif
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "NBTAttribute.h"
+#include "NBTContainer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 测试与基准访问容器/节点内部数据的唯一入口, 只在开启自动化测试的构建中存在
+struct FNBTTestAccess {
+    static const FNBTAllocator& GetAllocator(const FNBTContainer& Container) { return Container.Allocator; }
+
+    static FNBTAttribute* GetAttribute(const FNBTContainer& Container, FNBTAttributeID ID) { return Container.GetAttribute(ID); }
+
+    static int32* GetAttributeVersion(const FNBTContainer& Container, FNBTAttributeID ID) { return Container.GetAttributeVersion(ID); }
+
+    static int32* GetAttributeSubtreeVersion(const FNBTContainer& Container, FNBTAttributeID ID) { return Container.GetAttributeSubtreeVersion(ID); }
+
+    // Map节点下某个键的子节点ID, 节点不存在或不是Map时返回无效ID
+    static FNBTAttributeID FindMapChild(const FNBTContainer& Container, FNBTAttributeID MapID, FName Key) {
+        const FNBTAttribute* Attr = Container.GetAttribute(MapID);
+        const FNBTMapData* MapData = Attr ? Attr->GetMapData() : nullptr;
+        const FNBTAttributeID* ChildID = MapData ? MapData->Children.Find(Key) : nullptr;
+        return ChildID ? *ChildID : FNBTAttributeID();
+    }
+
+    template <typename T>
+    static FORCEINLINE TOptional<T> GetBaseType(const FNBTAttribute& Attr) { return Attr.GetBaseType<T>(); }
+};
+
+#endif